@@ -0,0 +1,47 @@
+"""Benchmark of eval_type per value type and of eval_type_batch (not collected by pytest).
+
+Run with :code:`python benchmarks/eval_type.py` against the baseline build and against the current build to compare
+the classifier, the absolute timings depend on the machine.
+"""
+from time import perf_counter
+
+import cornflakes
+
+SAMPLES = {"int": "123456", "float": "1234.5678", "hex": "0x1F", "bool": "false", "string": "value"}
+BATCH = ["123456", "1234.5678", "true", "value", "", "2006-03-17 13:27:54"] * 50000
+
+
+def best_time(func, repeat: int) -> float:
+    """Best time of func over repeat runs."""
+    best = float("inf")
+    for _ in range(repeat):
+        s = perf_counter()
+        func()
+        best = min(best, perf_counter() - s)
+    return best
+
+
+def per_type(repeat: int = 5, number: int = 100000):
+    """Print the best time of eval_type for one sample of each type."""
+    for name, value in SAMPLES.items():
+        timing = best_time(lambda value=value: [cornflakes.eval_type(value) for _ in range(number)], repeat)
+        print(f"{name:>8}: {timing / number * 1e9:.0f} ns")
+
+
+def batch(repeat: int = 5):
+    """Print the best time of eval_type_batch against an eval_type loop."""
+    single = best_time(lambda: [cornflakes.eval_type(value) for value in BATCH], repeat)
+    batched = best_time(lambda: cornflakes.eval_type_batch(BATCH), repeat)
+    print(f"    loop: {single * 1000:.2f} ms")
+    print(f"   batch: {batched * 1000:.2f} ms")
+    print(f" speedup: {single / batched:.1f}x")
+
+
+def main(repeat: int = 5):
+    """Print all eval_type timings."""
+    per_type(repeat)
+    batch(repeat)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,43 @@
+"""Benchmark of ini_dump against joining the sections in python (not collected by pytest).
+
+Run with :code:`python benchmarks/ini_dump.py`.
+"""
+from time import perf_counter
+
+import cornflakes
+from cornflakes.common import type_to_str
+
+
+def python_dump(sections) -> bytearray:
+    """Reference implementation of ini_dump in python."""
+    result = bytearray()
+    for title, values, _ in sections:
+        result.extend(bytes(f"[{title}]\n", "utf-8"))
+        result.extend(bytes("\n".join(f"{key}={type_to_str(value)!r}" for key, value in values.items()), "utf-8"))
+        result.extend(b"\n\n")
+    return result
+
+
+def main(repeat: int = 5):
+    """Print the best time of both implementations."""
+    sections = [
+        (f"section_{section}", {f"key_{key}": f"value_{key}" for key in range(50)}, None) for section in range(2000)
+    ]
+    implementations = {
+        "ini_dump": lambda: cornflakes.ini_dump(sections, type_to_str),
+        "python": lambda: python_dump(sections),
+    }
+    timings = {}
+    for name, dump in implementations.items():
+        best = float("inf")
+        for _ in range(repeat):
+            s = perf_counter()
+            dump()
+            best = min(best, perf_counter() - s)
+        timings[name] = best
+        print(f"{name:>8}: {best * 1000:.2f} ms")
+    print(f"speedup: {timings['python'] / timings['ini_dump']:.1f}x")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,41 @@
+"""Benchmark of ini_load for growing numbers of keys and sections (not collected by pytest).
+
+Run with :code:`python benchmarks/ini_load.py`, both timings should grow linearly (defined keys are hash lookups,
+sections are indexed in one pass).
+"""
+import os
+import tempfile
+from time import perf_counter
+
+import cornflakes
+
+
+def ini_load_time(sections: int, keys: int, repeat: int = 20) -> float:
+    """Time ini_load with all keys and with defined keys for a generated ini file."""
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        file = os.path.join(tmp_dir, "generated.ini")
+        with open(file, "w") as f:
+            for section in range(sections):
+                f.write(f"[section_{section}]\n")
+                f.write("".join(f"key_{key} = value_{key}\n" for key in range(keys)))
+        defined_keys = {f"key_{key}": [f"alias_{key}", f"key_{key}"] for key in range(keys)}
+
+        s = perf_counter()
+        for _ in range(repeat):
+            cornflakes.ini_load(file)
+            cornflakes.ini_load(file, keys=defined_keys)
+        return perf_counter() - s
+
+
+def main():
+    """Print the timings and their growth for 8x the keys and 8x the sections."""
+    for name, small, large in [
+        ("keys", {"sections": 4, "keys": 50}, {"sections": 4, "keys": 400}),
+        ("sections", {"sections": 5, "keys": 40}, {"sections": 40, "keys": 40}),
+    ]:
+        small_time, large_time = ini_load_time(**small), ini_load_time(**large)
+        print(f"{name:>8}: {small_time * 1000:.2f} ms -> {large_time * 1000:.2f} ms ({large_time / small_time:.1f}x)")
+
+
+if __name__ == "__main__":
+    main()
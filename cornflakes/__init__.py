@@ -1,5 +1,22 @@
 """Top Level Module."""  # noqa: RST303 D205
-from _cornflakes import apply_match, eval_csv, eval_datetime, eval_type, extract_between, ini_load, eval_json
+from _cornflakes import (
+    Environment,
+    IniParser,
+    IniReloader,
+    IniSelection,
+    IniStream,
+    apply_match,
+    eval_csv,
+    eval_datetime,
+    eval_json,
+    eval_type,
+    eval_type_batch,
+    extract_between,
+    ini_cache_clear,
+    ini_cache_info,
+    ini_dump,
+    ini_load,
+)
 from cornflakes.builder import generate_config_group_module
 from cornflakes.common import patch_module
 from cornflakes.logging import attach_log, setup_logging
@@ -11,7 +28,16 @@ __version__ = "3.3.28"  # <<FORCE_BUMP>>
 
 __all__ = [
     "ini_load",
+    "IniParser",
+    "IniSelection",
+    "IniReloader",
+    "IniStream",
+    "ini_dump",
+    "Environment",
+    "ini_cache_info",
+    "ini_cache_clear",
     "eval_type",
+    "eval_type_batch",
     "eval_datetime",
     "eval_csv",
     "eval_json",
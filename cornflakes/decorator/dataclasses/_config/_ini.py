@@ -1,6 +1,7 @@
 import logging
 from typing import Optional
 
+from cornflakes import ini_dump
 from cornflakes.common import type_to_str
 from cornflakes.decorator.dataclasses._config._load_config import create_file_loader
 from cornflakes.decorator.dataclasses._config._write_config import write_config
@@ -10,11 +11,14 @@ from cornflakes.types import Loader
 logger = logging.getLogger(__name__)
 
 
-def _parse_config_list(cfg, cfg_name: str, title: str):
-    _ini_bytes = bytearray()
+def _config_section(cfg, title: str):
+    return title, cfg, [slot for slot in get_not_ignored_slots(cfg) if slot != "section_name"]
+
+
+def _parse_config_list(cfg, cfg_name: str, title: str, sections: list):
     is_list = isinstance(cfg, list)
     if is_config(cfg) and not is_list:
-        return to_ini_bytes(cfg, cfg_name)
+        sections.append(_config_section(cfg, cfg_name))
     elif is_list:
         for n, sub_cfg in enumerate(cfg):
             sub_cfg_name = cfg_name
@@ -29,40 +33,24 @@ def _parse_config_list(cfg, cfg_name: str, title: str):
             if not sub_cfg_name:
                 sub_cfg_name = f"{cfg_name}_{n}"
 
-            _ini_bytes.extend(_parse_config_list(sub_cfg, sub_cfg_name, title))
-        return _ini_bytes
+            _parse_config_list(sub_cfg, sub_cfg_name, title, sections)
     else:
         logger.warning(f"The Value {cfg_name} of {title} be in a child config class!")
-        return b""
 
 
 def to_ini_bytes(
     self, title: str
 ) -> Optional[bytearray]:  # TODO: implement more type_to_str feature -> date format etc.
     """Method to write an instance of the main config class of the module into a ini bytearray."""
-    _ini_bytes = bytearray()
-    has_lists = isinstance(self, list)
-    if is_config(self) and not has_lists:
-        _ini_bytes.extend(bytes(f"[{title}]\n", "utf-8"))
-        _ini_bytes.extend(
-            bytes(
-                "\n".join(
-                    [
-                        f'{cfg}={f"{type_to_str(getattr(self, cfg))!r}" if getattr(self, cfg) is not None else ""}'
-                        for cfg in get_not_ignored_slots(self)
-                        if cfg != "section_name"
-                    ]
-                ),
-                "utf-8",
-            )
-        )
-        _ini_bytes.extend(b"\n\n")
-        return _ini_bytes
+    if is_config(self) and not isinstance(self, list):
+        return ini_dump([_config_section(self, title)], type_to_str)
 
+    sections: list = []
     for cfg_name in get_not_ignored_slots(self):
-        cfg = getattr(self, cfg_name)
-        _ini_bytes.extend(_parse_config_list(cfg, cfg_name, title))
+        _parse_config_list(getattr(self, cfg_name), cfg_name, title, sections)
 
+    # all sections are written into one buffer natively
+    _ini_bytes = ini_dump(sections, type_to_str)
     if _ini_bytes:
         _ini_bytes.pop()  # at least remove second line-break
 
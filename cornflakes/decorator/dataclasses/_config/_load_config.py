@@ -4,7 +4,7 @@ import logging
 import re
 from typing import Any, Callable, Dict, List, Optional, Union
 
-from cornflakes import ini_load
+from cornflakes import IniSelection, ini_load
 from cornflakes.common import recursive_update
 from cornflakes.decorator.dataclasses._helper import (
     alias_generator,
@@ -48,6 +48,8 @@ def create_file_loader(  # noqa: C901
         }
     else:
         keys = {key: getattr(f, "aliases", key) or key for key, f in dataclass_fields(cls).items()}
+    # compile the key selection once per config class (ini only)
+    loader_keys = {"selection": IniSelection(keys=keys)} if _loader_callback is ini_load else {"keys": keys}
 
     def _create_config(config_args: dict, allow_empty=None, **cls_kwargs) -> Optional[Union[dict, Any]]:
         if not config_args and allow_empty:
@@ -138,7 +140,9 @@ def create_file_loader(  # noqa: C901
 
             if not config_dict:
                 config_dict = OrderedDict(
-                    _loader_callback(files={None: files}, sections=section, keys=keys, defaults=None, eval_env=eval_env)
+                    _loader_callback(
+                        files={None: files}, sections=section, defaults=None, eval_env=eval_env, **loader_keys
+                    )
                 )
                 config_dict = _check_config_dict(config_dict)
 
@@ -155,7 +159,7 @@ def create_file_loader(  # noqa: C901
             return {section: config}
 
         if not config_dict:
-            raw_config_dict = OrderedDict(_loader_callback(files=files, sections=None, keys=keys, eval_env=eval_env))
+            raw_config_dict = OrderedDict(_loader_callback(files=files, sections=None, eval_env=eval_env, **loader_keys))
             config_dict = {}
             for file_name, section_config in raw_config_dict.items():
                 for section_name, config in section_config.items():
@@ -2,6 +2,29 @@
 
 #include <bindings.hpp>
 
+// key -> type mapping (None -> eval_type inference only)
+inline std::shared_ptr<const ini::Schema> LoadSchema(const py::object &schema) {
+  if (schema.is_none()) return nullptr;
+  return std::make_shared<const ini::Schema>(schema);
+}
+
+// arguments > compiled selection > keys of the defaults
+inline ini::Selection LoadSelection(const py::object &sections,
+                                    const py::object &keys,
+                                    const py::object &defaults,
+                                    const py::object &selection) {
+  ini::Selection m_selection(sections, keys);
+  if (!selection.is_none()) {
+    m_selection =
+        m_selection.WithDefaults(selection.cast<const ini::Selection &>());
+  }
+  if (m_selection.keys().empty() && !defaults.is_none()) {
+    m_selection = m_selection.WithDefaults(
+        ini::Selection(py::none(), defaults.attr("keys")));
+  }
+  return m_selection;
+}
+
 //! pybind module declaration
 PYBIND11_MODULE(_cornflakes, module) {
   module.doc() = R"pbdoc(
@@ -13,7 +36,16 @@ PYBIND11_MODULE(_cornflakes, module) {
            :toctree: _generate
 
             ini_load
+            IniParser
+            IniSelection
+            Environment
+            IniReloader
+            IniStream
+            ini_dump
+            ini_cache_info
+            ini_cache_clear
             eval_type
+            eval_type_batch
             eval_datetime
             eval_csv
             extract_between
@@ -32,42 +64,222 @@ PYBIND11_MODULE(_cornflakes, module) {
             :project: _cornflakes
         )pbdoc");
 
+  py::class_<ini::Selection>(module, "IniSelection", R"pbdoc(
+        Compiled sections / keys filter for ini_load (reusable).
+
+        .. doxygenclass:: ini::Selection
+            :project: _cornflakes
+      )pbdoc")
+      .def(py::init<const py::object &, const py::object &>(),
+           py::arg("sections").none(true) = py::none(),
+           py::arg("keys").none(true) = py::none());
+
+  py::class_<system_operations::Environment,
+             std::shared_ptr<system_operations::Environment>>(
+      module, "Environment", R"pbdoc(
+        Snapshot of the process environment for ini_load(eval_env=True).
+
+        .. doxygenclass:: system_operations::Environment
+            :project: _cornflakes
+      )pbdoc")
+      .def(py::init<>())
+      .def("__len__", &system_operations::Environment::size);
+
   module.def(
       "ini_load",
       [](const py::object &files, const py::object &sections,
          const py::object &keys, const py::object &defaults,
-         const bool &eval_env) -> py::dict {
+         const bool &eval_env, const py::object &selection,
+         const std::shared_ptr<system_operations::Environment> &environment,
+         const py::object &image, const bool &interpolate,
+         const bool &multiline, const py::object &schema,
+         const bool &stats) -> py::object {
         const auto m_files = string_operations::convert_to_map_str(files);
-        const auto m_sections = string_operations::convert_to_map_str(sections);
-        const auto m_keys =
-            keys.is_none()
-                ? string_operations::convert_to_map_str(
-                      defaults.is_none() ? defaults : defaults.attr("keys"))
-                : string_operations::convert_to_map_str(keys);
         const auto m_defaults = string_operations::convert_to_map_py(defaults);
-        return ini::ini_load(m_files, m_sections, m_keys, m_defaults, eval_env);
+        const auto m_selection =
+            LoadSelection(sections, keys, defaults, selection);
+        ini::LoadStats m_stats;
+        py::dict result = ini::ini_load(
+            m_files, m_selection, m_defaults, eval_env, environment,
+            image.is_none() ? std::string() : std::string(py::str(image)),
+            interpolate, multiline, LoadSchema(schema),
+            stats ? &m_stats : nullptr);
+        // stats -> (result, {nanoseconds per phase, counters})
+        if (stats) return py::make_tuple(result, m_stats.ToDict());
+        return std::move(result);
       },
       py::arg("files").none(true) = py::none(),
       py::arg("sections").none(true) = py::none(),
       py::arg("keys").none(true) = py::none(),
       py::arg("defaults").none(true) = py::none(),
       py::arg("eval_env").none(true) = py::cast(false),
+      py::arg("selection").none(true) = py::none(),
+      py::arg("environment").none(true) = py::none(),
+      py::arg("image").none(true) = py::none(),
+      py::arg("interpolate") = false, py::arg("multiline") = false,
+      py::arg("schema").none(true) = py::none(), py::arg("stats") = false,
       R"pbdoc(
         .. doxygenfunction:: ini::ini_load
             :project: _cornflakes
       )pbdoc");
 
+  py::class_<ini::Parser>(module, "IniParser", R"pbdoc(
+        Reusable ini_load, load() parses the files with the parser context
+        created once (for high-frequency callers).
+
+        .. doxygenclass:: ini::Parser
+            :project: _cornflakes
+      )pbdoc")
+      .def(py::init([](const py::object &files, const py::object &sections,
+                       const py::object &keys, const py::object &defaults,
+                       const bool &eval_env, const py::object &selection,
+                       const std::shared_ptr<system_operations::Environment>
+                           &environment,
+                       const py::object &image, const bool &interpolate,
+                       const bool &multiline, const py::object &schema) {
+             return std::make_unique<ini::Parser>(
+                 string_operations::convert_to_map_str(files),
+                 LoadSelection(sections, keys, defaults, selection),
+                 string_operations::convert_to_map_py(defaults), eval_env,
+                 environment,
+                 image.is_none() ? std::string() : std::string(py::str(image)),
+                 interpolate, multiline, LoadSchema(schema));
+           }),
+           py::arg("files").none(true) = py::none(),
+           py::arg("sections").none(true) = py::none(),
+           py::arg("keys").none(true) = py::none(),
+           py::arg("defaults").none(true) = py::none(),
+           py::arg("eval_env").none(true) = py::cast(false),
+           py::arg("selection").none(true) = py::none(),
+           py::arg("environment").none(true) = py::none(),
+           py::arg("image").none(true) = py::none(),
+           py::arg("interpolate") = false, py::arg("multiline") = false,
+           py::arg("schema").none(true) = py::none())
+      .def(
+          "load",
+          [](ini::Parser &parser, const bool &stats) -> py::object {
+            ini::LoadStats m_stats;
+            py::dict result = parser.load(stats ? &m_stats : nullptr);
+            if (stats) return py::make_tuple(result, m_stats.ToDict());
+            return std::move(result);
+          },
+          py::arg("stats") = false);
+
+  py::class_<ini::Reloader>(module, "IniReloader", R"pbdoc(
+        Incremental ini_load, reload() re-parses changed files only and
+        returns the changed paths.
+
+        .. doxygenclass:: ini::Reloader
+            :project: _cornflakes
+      )pbdoc")
+      .def(py::init([](const py::object &files, const py::object &sections,
+                       const py::object &keys, const py::object &defaults,
+                       const bool &eval_env, const py::object &selection,
+                       const std::shared_ptr<system_operations::Environment>
+                           &environment) {
+             return std::make_unique<ini::Reloader>(
+                 string_operations::convert_to_map_str(files),
+                 LoadSelection(sections, keys, defaults, selection),
+                 string_operations::convert_to_map_py(defaults), eval_env,
+                 environment);
+           }),
+           py::arg("files").none(true) = py::none(),
+           py::arg("sections").none(true) = py::none(),
+           py::arg("keys").none(true) = py::none(),
+           py::arg("defaults").none(true) = py::none(),
+           py::arg("eval_env").none(true) = py::cast(false),
+           py::arg("selection").none(true) = py::none(),
+           py::arg("environment").none(true) = py::none())
+      .def("reload", &ini::Reloader::reload)
+      .def_property_readonly("result", &ini::Reloader::result);
+
+  py::class_<ini::SectionStream>(module, "IniStream", R"pbdoc(
+        Iterator over the sections of a single (large) ini file, yields
+        (section, values) with only one section in memory.
+
+        .. doxygenclass:: ini::SectionStream
+            :project: _cornflakes
+      )pbdoc")
+      .def(py::init([](const std::string &file, const py::object &sections,
+                       const py::object &keys, const py::object &defaults,
+                       const bool &eval_env, const py::object &selection,
+                       const std::shared_ptr<system_operations::Environment>
+                           &environment,
+                       const std::size_t &chunk_size) {
+             return std::make_unique<ini::SectionStream>(
+                 file, LoadSelection(sections, keys, defaults, selection),
+                 string_operations::convert_to_map_py(defaults), eval_env,
+                 environment, chunk_size);
+           }),
+           py::arg("file").none(false),
+           py::arg("sections").none(true) = py::none(),
+           py::arg("keys").none(true) = py::none(),
+           py::arg("defaults").none(true) = py::none(),
+           py::arg("eval_env").none(true) = py::cast(false),
+           py::arg("selection").none(true) = py::none(),
+           py::arg("environment").none(true) = py::none(),
+           py::arg("chunk_size") = ini::STREAM_CHUNK_SIZE)
+      .def("__iter__",
+           [](ini::SectionStream &stream) -> ini::SectionStream & {
+             return stream;
+           },
+           py::return_value_policy::reference_internal)
+      .def("__next__", &ini::SectionStream::next)
+      .def_property_readonly("offset", &ini::SectionStream::offset);
+
+  module.def("ini_dump", &ini::ini_dump, py::arg("sections"),
+             py::arg("to_str").none(true) = py::none(),
+             R"pbdoc(
+        .. doxygenfunction:: ini::ini_dump
+            :project: _cornflakes
+      )pbdoc");
+
+  module.def("ini_cache_info", &ini::ini_cache_info,
+             R"pbdoc(
+        .. doxygenfunction:: ini::ini_cache_info
+            :project: _cornflakes
+      )pbdoc");
+
+  module.def("ini_cache_clear", &ini::ini_cache_clear,
+             R"pbdoc(
+        .. doxygenfunction:: ini::ini_cache_clear
+            :project: _cornflakes
+      )pbdoc");
+
+  // internal: compares the structural scanners in the tests
+  module.def(
+      "_ini_scan",
+      [](const std::string &contents, const std::string &scanner) {
+        return ini::StructuralPositions(contents,
+                                        ini::ParseScannerType(scanner));
+      },
+      py::arg("contents"), py::arg("scanner") = "auto");
+
+  // types of the value conversions (eval_type, schema, datetimes)
+  string_operations::init_py_types();
+
+  // cached python objects must be released before the interpreter shuts down
+  py::module::import("atexit").attr("register")(
+      py::cpp_function(&ini::ini_cache_clear));
+
   module.def(
       "eval_type",
-      [](const std::string &value) -> py::object {
-        return string_operations::eval_type(value);
+      [](const std::string &value, const bool &recursive) -> py::object {
+        return string_operations::eval_type(value, recursive);
       },
-      py::arg("value").none(false),
+      py::arg("value").none(false), py::arg("recursive") = false,
       R"pbdoc(
         .. doxygenfunction:: string_operations::eval_type
             :project: _cornflakes
         )pbdoc");
 
+  module.def("eval_type_batch", &string_operations::eval_type_batch,
+             py::arg("values"), py::arg("data") = py::none(),
+             R"pbdoc(
+        .. doxygenfunction:: string_operations::eval_type_batch
+            :project: _cornflakes
+        )pbdoc");
+
   module.def(
       "eval_datetime",
       [](const std::string &value) -> py::object {
@@ -9,7 +9,10 @@
 #include <string>
 #include <vector>
 #include <digest.hpp>
+#include <eval_batch.hpp>
 #include <ini.hpp>
+#include <ini_writer.hpp>
+#include <py_types.hpp>
 // clang-format on
 
 namespace py = pybind11;
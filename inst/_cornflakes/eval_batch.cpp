@@ -0,0 +1,163 @@
+// Copyright (c) 2022 Semjon Geist.
+#include <eval_batch.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <variant>
+
+//! eval_type over many values per call (classified without the GIL)
+namespace string_operations {
+// format characters of integer offsets (int32 / int64)
+inline const std::string_view OFFSET_FORMATS = "iIlLqQnN";
+
+inline TypeCode CodeOf(const py::handle &value) {
+  PyObject *object = value.ptr();
+  if (object == Py_None) return TypeCode::NONE;
+  if (PyBool_Check(object)) return TypeCode::BOOL;
+  if (PyLong_CheckExact(object)) return TypeCode::INT;
+  if (PyFloat_CheckExact(object)) return TypeCode::FLOAT;
+  if (PyUnicode_CheckExact(object)) return TypeCode::STR;
+  return TypeCode::OTHER;
+}
+
+// views into the utf-8 buffers of the str elements (None -> empty view),
+// items keeps the elements alive
+inline std::vector<std::string_view> SequenceViews(
+    const py::object &values, std::vector<py::object> *items) {
+  std::vector<std::string_view> result;
+  for (const auto &item : values) {
+    items->push_back(py::reinterpret_borrow<py::object>(item));
+    if (item.is_none()) {
+      result.emplace_back();
+      continue;
+    }
+    if (!PyUnicode_Check(item.ptr())) {
+      throw py::type_error(
+          std::string("eval_type_batch expects str values, got ") +
+          Py_TYPE(item.ptr())->tp_name);
+    }
+    Py_ssize_t size = 0;
+    const char *utf8 = PyUnicode_AsUTF8AndSize(item.ptr(), &size);
+    if (!utf8) throw py::error_already_set();
+    result.emplace_back(utf8, static_cast<std::size_t>(size));
+  }
+  return result;
+}
+
+inline void CheckContiguous(const py::buffer_info &buffer, const char *name) {
+  if (buffer.ndim != 1 || buffer.strides[0] != buffer.itemsize) {
+    throw std::invalid_argument(std::string(name) +
+                                " must be a contiguous 1-dimensional buffer");
+  }
+}
+
+inline std::int64_t OffsetAt(const py::buffer_info &offsets,
+                             const std::size_t &idx) {
+  const char *item =
+      static_cast<const char *>(offsets.ptr) + idx * offsets.itemsize;
+  if (offsets.itemsize == sizeof(std::int32_t)) {
+    std::int32_t offset;
+    std::memcpy(&offset, item, sizeof(offset));
+    return offset;
+  }
+  std::int64_t offset;
+  std::memcpy(&offset, item, sizeof(offset));
+  return offset;
+}
+
+// views of an offsets + data layout (arrow string / large_string arrays),
+// value idx is data[offsets[idx]:offsets[idx + 1]]
+inline std::vector<std::string_view> BufferViews(
+    const py::buffer_info &offsets, const py::buffer_info &data) {
+  CheckContiguous(offsets, "offsets");
+  CheckContiguous(data, "data");
+  if ((offsets.itemsize != sizeof(std::int32_t) &&
+       offsets.itemsize != sizeof(std::int64_t)) ||
+      OFFSET_FORMATS.find(offsets.format.back()) == std::string_view::npos) {
+    throw std::invalid_argument("offsets must be int32 or int64 values");
+  }
+  if (data.itemsize != 1) {
+    throw std::invalid_argument("data must be a buffer of bytes");
+  }
+  if (!offsets.size) throw std::invalid_argument("offsets must not be empty");
+
+  const char *contents = static_cast<const char *>(data.ptr);
+  std::vector<std::string_view> result;
+  result.reserve(offsets.size - 1);
+  std::int64_t begin = OffsetAt(offsets, 0);
+  for (py::ssize_t idx = 1; idx < offsets.size; ++idx) {
+    const std::int64_t end = OffsetAt(offsets, idx);
+    if (begin < 0 || end < begin || end > data.size) {
+      throw std::invalid_argument("invalid offset " + std::to_string(end) +
+                                  " at index " + std::to_string(idx));
+    }
+    result.emplace_back(contents + begin,
+                        static_cast<std::size_t>(end - begin));
+    begin = end;
+  }
+  return result;
+}
+
+/// This is a simple C++ function to cast many strings into python objects
+/// like eval_type, the values are classified without the GIL (on several
+/// threads for large batches) and repeated values are evaluated once
+///
+/// @param values iterable of str (list, tuple, numpy object array, None ->
+/// None) or the int32 / int64 offsets (size + 1 entries) into data
+/// @param data utf-8 buffer of the values (None -> values are str)
+/// @returns tuple of the list of python objects and the bytes of their type
+/// codes (0 none, 1 bool, 2 int, 3 float, 4 str, 5 other)
+py::tuple eval_type_batch(const py::object &values, const py::object &data) {
+  std::vector<py::object> items;
+  py::buffer_info offsets_buffer;
+  py::buffer_info data_buffer;
+  std::vector<std::string_view> views;
+  if (data.is_none()) {
+    views = SequenceViews(values, &items);
+  } else {
+    offsets_buffer = py::reinterpret_borrow<py::buffer>(values).request();
+    data_buffer = py::reinterpret_borrow<py::buffer>(data).request();
+    views = BufferViews(offsets_buffer, data_buffer);
+  }
+
+  std::vector<ini::Value> classified(views.size());
+  {
+    py::gil_scoped_release release;
+    const std::size_t chunks =
+        (views.size() + BATCH_CHUNK_SIZE - 1) / BATCH_CHUNK_SIZE;
+    system_operations::parallel_for(chunks, [&](std::size_t chunk) {
+      const std::size_t end =
+          std::min(views.size(), (chunk + 1) * BATCH_CHUNK_SIZE);
+      for (std::size_t idx = chunk * BATCH_CHUNK_SIZE; idx < end; ++idx) {
+        classified[idx] = ini::ClassifyValue(views[idx]);
+      }
+    });
+  }
+
+  ini::TypedValues typed_values;  // memo of deferred values (views)
+  py::list result;
+  std::string codes(views.size(), '\0');
+  for (std::size_t idx = 0; idx < views.size(); ++idx) {
+    const ini::Value &value = classified[idx];
+    const auto *string = std::get_if<std::string_view>(&value.data);
+    // unchanged str elements are returned as they are
+    if (string && string->size() == views[idx].size() && !items.empty() &&
+        PyUnicode_CheckExact(items[idx].ptr())) {
+      result.append(items[idx]);
+      codes[idx] = static_cast<char>(TypeCode::STR);
+      continue;
+    }
+    py::object item = ini::ToPyObject(value, &typed_values);
+    codes[idx] = static_cast<char>(
+        std::holds_alternative<ini::DeferredValue>(value.data)
+            ? CodeOf(item)
+            : static_cast<TypeCode>(value.data.index()));
+    result.append(std::move(item));
+  }
+  return py::make_tuple(std::move(result),
+                        py::bytes(codes.data(), codes.size()));
+}
+
+}  // namespace string_operations
@@ -0,0 +1,32 @@
+// Copyright (c) 2022 Semjon Geist.
+#ifndef INST__CORNFLAKES_EVAL_BATCH_HPP_
+#define INST__CORNFLAKES_EVAL_BATCH_HPP_
+
+// clang-format off
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include <ini_tree.hpp>
+#include <string_operations.hpp>
+#include <system_operations.hpp>
+// clang-format on
+
+namespace string_operations {  // cppcheck-suppress syntaxError
+// elements classified per work item of eval_type_batch
+inline const std::size_t BATCH_CHUNK_SIZE = 4096;
+
+// Type code of an eval_type_batch result (same order as the native
+// alternatives of ini::Value, OTHER -> datetime, uuid, ip, json, Decimal ...)
+enum class TypeCode : std::uint8_t {
+  NONE,
+  BOOL,
+  INT,
+  FLOAT,
+  STR,
+  OTHER,
+};
+
+py::tuple eval_type_batch(const py::object &values, const py::object &data);
+}  // namespace string_operations
+
+#endif  // INST__CORNFLAKES_EVAL_BATCH_HPP_
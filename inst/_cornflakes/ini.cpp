@@ -7,360 +7,489 @@ namespace ini {
 // Parser Config (User-Input)
 struct ParserConfig {
   std::map<std::string, std::vector<std::string>> files;
-  std::map<std::string, std::vector<std::string>> sections;
-  std::map<std::string, std::vector<std::string>> keys;
+  Selection selection;  // compiled sections / keys
   std::map<std::string, std::vector<py::object>> defaults;
   py::dict envir;  // MAIN ENVIRONMENT for configs
   ParserConfig(std::map<std::string, std::vector<std::string>> t_files,
-               std::map<std::string, std::vector<std::string>> t_sections,
-               std::map<std::string, std::vector<std::string>> t_keys,
+               Selection t_selection,
                std::map<std::string, std::vector<py::object>> t_defaults,
                py::dict t_envir)
       : files(std::move(t_files)),
-        sections(std::move(t_sections)),
-        keys(std::move(t_keys)),
+        selection(std::move(t_selection)),
         defaults(std::move(t_defaults)),
         envir(std::move(t_envir)) {}
 };
 
 // Input File Data
 struct FileData {
-  py::dict file_envir;   // File ENVIRONMENT for configs
-  std::string contents;  // content read into
-  FileData(py::dict t_file_envir, std::string t_contents)
-      : file_envir(std::move(t_file_envir)), contents(std::move(t_contents)) {}
+  std::shared_ptr<const FileIndex> index;  // shared contents + sections / keys
+  std::shared_ptr<TypedValues> values;     // typed values (cached)
+  Interpolator *interpolator = nullptr;    // nullptr -> values verbatim
+  const Schema *schema = nullptr;          // nullptr -> eval_type inference
+  explicit FileData(CachedFile t_file)
+      : index(std::move(t_file.index)), values(std::move(t_file.values)) {}
 };
 
 // Section Meta Data
 struct SectionData {
-  py::dict section_envir;             // Section ENVIRONMENT for configs
-  std::array<int, 2> section_cursor;  // section id / idx-begin idx-end
-  FileData m_FileData;
-  SectionData(py::dict t_section_envir, std::array<int, 2> t_section_cursor,
-              FileData t_FileData)
-      : section_envir(std::move(t_section_envir)),
-        section_cursor(t_section_cursor),
-        m_FileData(std::move(t_FileData)) {}
+  std::vector<KeyUpdate> *updates;         // native result of the section
+  std::array<std::size_t, 2> line_cursor;  // line idx-begin idx-end
+  std::shared_ptr<const KeyIndex> keys;    // key index (nullptr -> on demand)
+  std::shared_ptr<const FileIndex> m_FileIndex;  // Parent ini data
+  Interpolator *interpolator;
+  const Schema *schema;
+  SectionData(std::vector<KeyUpdate> *t_updates,
+              std::array<std::size_t, 2> t_line_cursor,
+              std::shared_ptr<const KeyIndex> t_keys,
+              const FileData &t_FileData)
+      : updates(t_updates),
+        line_cursor(t_line_cursor),
+        keys(std::move(t_keys)),
+        m_FileIndex(t_FileData.index),
+        interpolator(t_FileData.interpolator),
+        schema(t_FileData.schema) {}
+  // typed value of the file (references substituted before typing)
+  Value Classify(const std::string_view &value) const {
+    if (!interpolator) return ClassifyValue(value);
+    const std::string_view resolved = interpolator->Resolve(value);
+    return ClassifyValue(resolved, resolved.data() == value.data());
+  }
+  // typed value of a key (schema type if the key is typed)
+  Value Classify(const std::string_view &key,
+                 const std::string_view &value) const {
+    const SchemaType type = schema ? schema->find(key) : SchemaType::ANY;
+    if (type == SchemaType::ANY) return Classify(value);
+    const std::string_view resolved =
+        interpolator ? interpolator->Resolve(value) : value;
+    return ClassifyTyped(key, resolved, type,
+                         resolved.data() == value.data());
+  }
+  // typed value of an environment variable
+  Value ClassifyEnv(const std::string_view &key,
+                    const std::string &value) const {
+    const SchemaType type = schema ? schema->find(key) : SchemaType::ANY;
+    if (type == SchemaType::ANY) return ClassifyValue(value, false);
+    return ClassifyTyped(key, value, type, false);
+  }
 };
 
-// Parser Process Data
+// Parser Process Data (ParseSections / ParseKeys never touch python objects)
 struct ParserData {
-  std::function<void(FileData data, ParserData m_ParserData)> ParseSections;
-  std::function<void(SectionData data, ParserData m_ParserData)> ParseKeys;
+  std::function<void(const FileData &data, const ParserData &m_ParserData,
+                     FileTree *tree)>
+      ParseSections;
+  std::function<void(const SectionData &data, const ParserData &m_ParserData)>
+      ParseKeys;
   ParserConfig m_ParserConfig;
-  const bool eval_env;
-  ParserData(std::function<void(FileData data, ParserData m_ParserData)>
+  // environment snapshot (nullptr -> eval_env disabled)
+  std::shared_ptr<const system_operations::Environment> environment;
+  // environment of ${...} references (nullptr -> interpolation disabled)
+  std::shared_ptr<const system_operations::Environment> interpolation;
+  bool multiline = false;     // join continuation lines
+  LoadStats *stats = nullptr;  // timings / counters (nullptr -> disabled)
+  PyNames *names = nullptr;    // section / key names (set while loading)
+  // key types of typed values (nullptr -> eval_type inference)
+  std::shared_ptr<const Schema> schema;
+  ParserData(std::function<void(const FileData &data,
+                                const ParserData &m_ParserData,
+                                FileTree *tree)>
                  t_ParseSections,
-             std::function<void(SectionData data, ParserData m_ParserData)>
+             std::function<void(const SectionData &data,
+                                const ParserData &m_ParserData)>
                  t_ParseKeys,
-             ParserConfig t_ParserConfig, const bool &t_eval_env)
+             ParserConfig t_ParserConfig,
+             std::shared_ptr<const system_operations::Environment>
+                 t_environment)
       : ParseSections(std::move(t_ParseSections)),
         ParseKeys(std::move(t_ParseKeys)),
         m_ParserConfig(std::move(t_ParserConfig)),
-        eval_env(t_eval_env) {}
+        environment(std::move(t_environment)) {}
 };
 
-inline void ParseAllKeys(SectionData t_SectionData,
+inline py::str ToPyStr(const std::string_view &value) {
+  return {value.data(), value.size()};
+}
+
+inline SectionTree *AddSection(FileTree *tree, const SectionTarget &target,
+                               const std::string_view &name = {}) {
+  tree->sections.push_back({target, name, {}, {}});
+  return &tree->sections.back();
+}
+
+inline void ParseAllKeys(const SectionData &t_SectionData,
                          const ParserData &t_ParserData) {
-  std::string::const_iterator start_iter =
-      t_SectionData.m_FileData.contents.begin();
-  std::string::const_iterator end_iter =
-      t_SectionData.m_FileData.contents.begin();
+  const FileIndex &index = *t_SectionData.m_FileIndex;
+  const auto entry_cursor = EntryCursor(index, t_SectionData.line_cursor);
+  // a repeated key keeps the position of its first entry (dict semantics),
+  // only the last value is materialized
+  std::unordered_map<std::string_view, std::size_t> positions;
+
+  // entries are already split into name and value (empty values are skipped)
+  for (std::size_t idx = entry_cursor[0]; idx < entry_cursor[1]; ++idx) {
+    const KeyValueView &entry = index.entries[idx];
+    const auto position =
+        positions.emplace(entry.key, t_SectionData.updates->size());
+    if (position.second) {
+      t_SectionData.updates->push_back(
+          {UpdateType::SET, entry.key,
+           t_SectionData.Classify(entry.key, entry.value)});
+    } else {
+      (*t_SectionData.updates)[position.first->second].value =
+          t_SectionData.Classify(entry.key, entry.value);
+    }
+  }
+}
 
-  std::advance(start_iter, t_SectionData.section_cursor[0]);
-  std::advance(end_iter, t_SectionData.section_cursor[1]);
-  start_iter =
-      std::find(start_iter, end_iter,
-                system_operations::NEWLINE);  // next line after section header
+// collect all values of lines containing the key (1=list, 2=dict)
+inline void ParseWildcardKeys(const SectionData &t_SectionData,
+                              const std::string &key_name,
+                              const std::string &item_value, const int &type) {
+  const FileIndex &index = *t_SectionData.m_FileIndex;
+  ValueList list_values;
+  ValueDict dict_values;
 
-  std::string::const_iterator next_line_iter =
-      std::find(start_iter, end_iter, system_operations::NEWLINE);
-  std::string::const_iterator next_value_iter;
+  for (std::size_t idx = t_SectionData.line_cursor[0];
+       idx < t_SectionData.line_cursor[1]; ++idx) {
+    const std::string_view &line = index.lines[idx].line;
+    std::size_t start_idx = line.find(item_value);
 
-  // // split name and value for each line if not empty or comment
-  while (next_line_iter != end_iter) {
-    start_iter = next_line_iter + 1;  // skip line
+    while (start_idx != std::string_view::npos) {
+      const std::size_t value_idx = line.find(NEWVALUE, start_idx + 1);
+      if (value_idx == std::string_view::npos) break;
 
-    next_line_iter =
-        std::find(start_iter, end_iter, system_operations::NEWLINE);
-    next_line_iter = std::find(start_iter, next_line_iter, COMMENT_CHAR);
-    next_value_iter = std::find(start_iter, next_line_iter, NEWVALUE);
+      const std::string_view value = TrimView(line.substr(value_idx + 1));
 
-    //            if () {
-    //                break;
-    //            }
+      if (!value.empty()) {
+        switch (type) {
+          case 1:
+            list_values.push_back(t_SectionData.Classify(value));
+            break;
+          case 2:
+            dict_values.emplace_back(
+                line.substr(start_idx, value_idx - start_idx),
+                t_SectionData.Classify(value));
+            break;
+        }
+      }
 
-    if (start_iter == next_value_iter) continue;
+      start_idx = line.find(item_value, value_idx);
+    }
+  }
 
-    std::string value = string_operations::trim(
-        std::string(next_value_iter, next_line_iter).erase(0, 1));
-    if (!value.empty())
-      t_SectionData.section_envir[py::cast(string_operations::trim(std::string(
-          start_iter, next_value_iter)))] = string_operations::eval_type(value);
+  if (!list_values.empty()) {
+    t_SectionData.updates->push_back(
+        {UpdateType::EXTEND, key_name, {std::move(list_values)}});
+  }
+  if (!dict_values.empty()) {
+    t_SectionData.updates->push_back(
+        {UpdateType::UPDATE, key_name, {std::move(dict_values)}});
   }
 }
 
-inline void ParseDefinedKeys(SectionData t_SectionData,
+inline void ParseDefinedKeys(const SectionData &t_SectionData,
                              const ParserData &t_ParserData) {
-  for (const auto &item : t_ParserData.m_ParserConfig.keys) {
-    for (auto item_value : item.second) {
-      int type = 0;  // default, 1=list, 2=dict
-      std::string::const_iterator start_iter =
-          t_SectionData.m_FileData.contents.begin();
-      std::string::const_iterator end_iter =
-          t_SectionData.m_FileData.contents.begin();
-      std::advance(start_iter, t_SectionData.section_cursor[0]);
-      std::advance(end_iter, t_SectionData.section_cursor[1]);
-
-      std::string::const_iterator line_iter;
-      std::string::const_iterator value_iter = std::find(
-          start_iter, end_iter,
-          system_operations::NEWLINE);  // next line after section header
-
-      if (item_value == "*") {
-        type = 1;
-        item_value = item.first;
-      }
-      if (item_value == "**") {
-        type = 2;
-        item_value = item.first;
-      }
-
-      while (true) {
-        // get value
-        start_iter = std::search(value_iter, end_iter, item_value.begin(),
-                                 item_value.end());
-        if (start_iter == end_iter) {
-          if (!t_SectionData.section_envir
-                   .attr("get")(py::cast(item.first), py::none())
-                   .is_none()) {
-            break;
-          }
-          if (t_ParserData.eval_env) {
-            char *env_value = std::getenv(item_value.c_str());
-            if (env_value == nullptr) {
-              std::transform(item_value.begin(), item_value.end(),
-                             item_value.begin(), ::toupper);
-              env_value = std::getenv(item_value.c_str());
-            }
-            if (env_value != nullptr) {
-              t_SectionData.section_envir[py::cast(item.first)] =
-                  t_SectionData.section_envir.attr("get")(
-                      py::cast(item.first),
-                      string_operations::eval_type(env_value));
-              break;
-            }
-          }
-          if (!t_ParserData.m_ParserConfig.defaults.empty()) {
-            auto default_value =
-                t_ParserData.m_ParserConfig.defaults.find(item.first);
-            if (default_value != t_ParserData.m_ParserConfig.defaults.end()) {
-              if (!default_value->second.empty()) {
-                t_SectionData.section_envir[py::cast(item.first)] =
-                    t_SectionData.section_envir.attr("get")(
-                        py::cast(item.first), default_value->second[0]);
-                break;
-              }
-              t_SectionData.section_envir[py::cast(item.first)] =
-                  t_SectionData.section_envir.attr("get")(py::cast(item.first),
-                                                          py::none());
-            }
-          }
-          break;
-        }
+  std::shared_ptr<const KeyIndex> keys = t_SectionData.keys;
+  if (!keys) {
+    keys = std::make_shared<const KeyIndex>(
+        BuildKeyIndex(*t_SectionData.m_FileIndex, t_SectionData.line_cursor));
+  }
 
-        line_iter =
-            std::find(start_iter + 1, end_iter, system_operations::NEWLINE);
-        value_iter = std::find(start_iter + 1, line_iter, NEWVALUE);
+  for (const auto &item : t_ParserData.m_ParserConfig.selection.keys()) {
+    const bool has_default = t_ParserData.m_ParserConfig.defaults.find(
+                                 item.name) !=
+                             t_ParserData.m_ParserConfig.defaults.end();
 
-        // get total key name if only prefix
-        while (true) {
-          if (type || std::string(start_iter - 1, start_iter).c_str()[0] ==
-                          system_operations::NEWLINE)
-            break;
-          --start_iter;
+    for (const auto &alias : item.aliases) {
+      // get value (hash lookup of the last non-empty value)
+      if (alias.type) {
+        ParseWildcardKeys(t_SectionData, item.name, alias.name, alias.type);
+      } else {
+        const auto key_iter = keys->find(alias.name);
+        if (key_iter != keys->end()) {
+          t_SectionData.updates->push_back(
+              {UpdateType::SET, item.name,
+               t_SectionData.Classify(item.name, key_iter->second)});
         }
+      }
 
-        std::string value = string_operations::trim(
-            std::string(value_iter, line_iter).erase(0, 1));
-
-        if (!value.empty()) {
-          switch (type) {
-            case 1: {
-              t_SectionData.section_envir[py::cast(item.first)] =
-                  t_SectionData.section_envir.attr("get")(py::cast(item.first),
-                                                          py::list());
-              t_SectionData.section_envir[py::cast(item.first)].attr("append")(
-                  string_operations::eval_type(value));
-            } break;
-            case 2: {
-              t_SectionData.section_envir[py::cast(item.first)] =
-                  t_SectionData.section_envir.attr("get")(py::cast(item.first),
-                                                          py::dict());
-              t_SectionData.section_envir[py::cast(item.first)][py::cast(
-                  std::string(start_iter, value_iter))] =
-                  string_operations::eval_type(value);
-            } break;
-            default: {
-              if (string_operations::trim(
-                      std::string(start_iter, value_iter)) != item_value)
-                continue;
-              t_SectionData.section_envir[py::cast(item.first)] =
-                  string_operations::eval_type(value);
-            } break;
-          }
-          continue;
+      // environment / default value (applied if the key is still None)
+      KeyUpdate fallback{UpdateType::FALLBACK, item.name, {}, false};
+      if (t_ParserData.environment) {
+        const std::string *env_value =
+            t_ParserData.environment->find(alias.name, alias.env_name);
+        if (env_value != nullptr) {
+          fallback.value = t_SectionData.ClassifyEnv(item.name, *env_value);
+          fallback.has_value = true;
         }
-
-        start_iter += 1;
+      }
+      if (fallback.has_value || has_default) {
+        t_SectionData.updates->push_back(std::move(fallback));
       }
     }
   }
 }
 
-inline int GetNextSectionIdx(FileData t_FileData, int idx) {
-  idx = static_cast<int>(
-      t_FileData.contents.find_first_of(SECTION_OPEN_CHAR, idx) + 1);
-  while (idx && t_FileData.contents.at(idx - 2) != system_operations::NEWLINE) {
-    idx = static_cast<int>(
-        t_FileData.contents.find_first_of(SECTION_OPEN_CHAR, idx) + 1);
-  }
-  if (!idx) {
-    idx = static_cast<int>(t_FileData.contents.size() - 1);
-  }
-  return idx;
-}
-
-inline void ParseSectionsDefault(FileData t_FileData,
+inline void ParseSectionsDefault(const FileData &t_FileData,
                                  const ParserData &t_ParserData,
-                                 py::dict section_envir,
+                                 std::vector<KeyUpdate> *updates,
                                  bool defaults_only = false,
                                  bool first_section_only = false) {
-  std::array<int, 2> section_cursor{};
-  t_FileData.contents.insert(0, 1, system_operations::NEWLINE);
-  section_cursor[0] = static_cast<int>(
-      defaults_only * static_cast<int>(t_FileData.contents.size()));
-  section_cursor[1] = GetNextSectionIdx(
-      t_FileData, first_section_only
-                      ? GetNextSectionIdx(t_FileData, section_cursor[0])
-                      : static_cast<int>(t_FileData.contents.size() - 1));
+  const FileIndex &index = *t_FileData.index;
+  std::array<std::size_t, 2> line_cursor{0, index.lines.size()};
+  if (defaults_only) {
+    line_cursor[1] = 0;
+  } else if (first_section_only && index.sections.size() > 1) {
+    // until the header line of the second section
+    line_cursor[1] = index.sections[1].line_cursor[0] - 1;
+  }
   // parse all keys in all sections for config without section
-  t_ParserData.ParseKeys(
-      SectionData(std::move(section_envir),  // Section Environment
-                  section_cursor,            // Cursor for content
-                  t_FileData),               // Parent ini data
-      t_ParserData);
+  t_ParserData.ParseKeys(SectionData(updates,      // Section result
+                                     line_cursor,  // Cursor for lines
+                                     nullptr,      // Key index (on demand)
+                                     t_FileData),  // Parent ini data
+                         t_ParserData);
+}
+
+inline std::shared_ptr<const KeyIndex> SectionKeys(const FileData &t_FileData,
+                                                   const std::size_t &idx) {
+  // aliasing pointer -> shares ownership of the file index
+  return {t_FileData.index, &t_FileData.index->sections[idx].keys};
 }
 
 // parse all sections
 inline void ParseAllSections(const FileData &t_FileData,
-                             const ParserData &t_ParserData) {
-  std::array<int, 2> section_cursor{};
-  section_cursor[1] = (t_FileData.contents.empty() ||
-                       t_FileData.contents.at(0) == SECTION_OPEN_CHAR.at(0))
-                          ? 1
-                          : GetNextSectionIdx(t_FileData, 0);
-
-  if (section_cursor[1] >= static_cast<int>(t_FileData.contents.size() - 1)) {
-    t_FileData.file_envir[py::none()] = py::dict();
-    ParseSectionsDefault(t_FileData, t_ParserData,
-                         t_FileData.file_envir[py::none()],
-                         t_FileData.contents.empty());
+                             const ParserData &t_ParserData, FileTree *tree) {
+  const FileIndex &index = *t_FileData.index;
+
+  if (index.sections.empty()) {
+    SectionTree *section = AddSection(tree, SectionTarget::DEFAULT);
+    ParseSectionsDefault(t_FileData, t_ParserData, &section->updates,
+                         index.contents->view().empty());
     return;
   }
-  // split name and value for each line if not empty or comment
-  while (true) {
-    section_cursor[0] = static_cast<int>(t_FileData.contents.find_first_of(
-        SECTION_CLOSE_CHAR, section_cursor[1]));
-
-    std::string section_name = t_FileData.contents.substr(
-        section_cursor[1], section_cursor[0] - section_cursor[1]);
 
-    t_FileData.file_envir[py::cast(section_name)] =
-        t_FileData.file_envir.attr("get")(py::cast(section_name), py::dict());
-
-    section_cursor[1] = GetNextSectionIdx(t_FileData, section_cursor[1]);
-
-    if (section_cursor[1] == static_cast<int>(t_FileData.contents.size() - 1)) {
-      t_ParserData.ParseKeys(
-          SectionData(
-              t_FileData
-                  .file_envir[py::cast(section_name)],  // Section Environment
-              section_cursor,                           // Cursor for content
-              t_FileData),                              // Parent ini data
-          t_ParserData);
-      break;
-    }
+  tree->sections.reserve(index.sections.size());
+  for (std::size_t idx = 0; idx < index.sections.size(); ++idx) {
+    SectionTree *section =
+        AddSection(tree, SectionTarget::SECTION, index.sections[idx].name);
 
     t_ParserData.ParseKeys(
-        SectionData(
-            t_FileData
-                .file_envir[py::cast(section_name)],  // Section Environment
-            section_cursor,                           // Cursor for content
-            t_FileData),                              // Parent ini data
+        SectionData(&section->updates,                // Section result
+                    index.sections[idx].line_cursor,  // Cursor for lines
+                    SectionKeys(t_FileData, idx),     // Key index
+                    t_FileData),                      // Parent ini data
         t_ParserData);
   }
 }
 
-inline void ParseDefinedSections(FileData t_FileData,
-                                 const ParserData &t_ParserData) {
-  for (const auto &item : t_ParserData.m_ParserConfig.sections) {
-    py::dict section_envir;
-    if (string_operations::is_nan(item.first)) {
-      section_envir = t_FileData.file_envir;
-    } else {
-      t_FileData.file_envir[py::cast(item.first)] =
-          t_FileData.file_envir.attr("get")(py::cast(item.first), py::dict());
-      section_envir = t_FileData.file_envir[py::cast(item.first)];
-    }
-    if (item.second.empty()) {
-      if (string_operations::is_nan(item.first)) {
-        ParseSectionsDefault(t_FileData, t_ParserData, section_envir, false,
-                             true);
-        continue;
-      }
-      ParseSectionsDefault(t_FileData, t_ParserData, section_envir);
+inline void ParseDefinedSections(const FileData &t_FileData,
+                                 const ParserData &t_ParserData,
+                                 FileTree *tree) {
+  const FileIndex &index = *t_FileData.index;
+
+  for (const auto &item : t_ParserData.m_ParserConfig.selection.sections()) {
+    SectionTree *section =
+        item.is_nan ? AddSection(tree, SectionTarget::FILE)
+                    : AddSection(tree, SectionTarget::SECTION, item.name);
+    if (item.sections.empty()) {
+      ParseSectionsDefault(t_FileData, t_ParserData, &section->updates,
+                           false, item.is_nan);
       continue;
     }
 
-    for (const auto &item_value : item.second) {
-      // config.begin_pattern is section name + pattern
-      std::array<int, 2> section_cursor = string_operations::idx_between(
-          t_FileData.contents.begin(), t_FileData.contents.end(),
-          SECTION_OPEN_CHAR + item_value + SECTION_CLOSE_CHAR, BEGIN_PATTERN,
-          0);
+    for (const auto &item_value : item.sections) {
+      const auto section_iter = index.section_lookup.find(item_value.name);
 
-      if (section_cursor == string_operations::empty_idx) {
+      if (section_iter == index.section_lookup.end()) {
         // handling if section not found or has no section
-        if (!string_operations::is_nan(item_value)) {
-          continue;
-        }
-        if (string_operations::is_nan(item.first)) {
-          ParseSectionsDefault(t_FileData, t_ParserData, section_envir, false,
-                               true);
+        if (!item_value.is_nan) {
           continue;
         }
-        ParseSectionsDefault(t_FileData, t_ParserData, section_envir);
+        ParseSectionsDefault(t_FileData, t_ParserData, &section->updates,
+                             false, item.is_nan);
         continue;
       }
 
-      section_cursor[0] += static_cast<int>(item_value.size() + 1);
-      section_cursor[1] -= static_cast<int>(BEGIN_PATTERN.size() - 1);
-
       // parse all keys
-      t_ParserData.ParseKeys(SectionData(section_envir,   // Section Environment
-                                         section_cursor,  // Cursor for content
-                                         t_FileData),     // Parent ini data
-                             t_ParserData);
+      t_ParserData.ParseKeys(
+          SectionData(&section->updates,  // Section result
+                      index.sections[section_iter->second]
+                          .line_cursor,  // Cursor for lines
+                      SectionKeys(t_FileData, section_iter->second),
+                      t_FileData),  // Parent ini data
+          t_ParserData);
+    }
+
+    ParseSectionsDefault(t_FileData, t_ParserData,
+                         &section->defaults_if_empty, true);
+  }
+}
+
+// parse a file into its native tree (references substituted if enabled)
+inline void ParseFile(const CachedFile &file, const ParserData &t_ParserData,
+                      FileTree *tree) {
+  FileData m_FileData(file);
+  m_FileData.schema = t_ParserData.schema.get();
+  std::unique_ptr<Interpolator> interpolator;
+  if (t_ParserData.interpolation &&
+      HasReferences(file.index->contents->view())) {
+    interpolator = std::make_unique<Interpolator>(
+        *file.index, *t_ParserData.interpolation, &tree->strings);
+    m_FileData.interpolator = interpolator.get();
+  }
+  t_ParserData.ParseSections(m_FileData, t_ParserData, tree);
+}
+
+// python string of a section / key name (one object per name and load)
+inline py::str Name(const std::string_view &name,
+                    const ParserData &t_ParserData) {
+  if (!t_ParserData.names) return ToPyStr(name);
+  return t_ParserData.names->Get(name);
+}
+
+// value of a dict key without a method call (nullptr -> missing)
+inline PyObject *DictItem(const py::dict &dict, const py::str &key) {
+  PyObject *item = PyDict_GetItemWithError(dict.ptr(), key.ptr());
+  if (!item && PyErr_Occurred()) throw py::error_already_set();
+  return item;
+}
+
+// fallback values only fill missing keys (keys set to None are kept)
+inline void ApplyFallback(const KeyUpdate &update, const py::str &key_name,
+                          const py::dict &section_envir,
+                          const FileData &t_FileData,
+                          const ParserData &t_ParserData) {
+  if (DictItem(section_envir, key_name)) return;
+  if (update.has_value) {
+    section_envir[key_name] = ToPyObject(
+        update.value, t_FileData.values.get(), t_ParserData.stats);
+    return;
+  }
+  auto default_value =
+      t_ParserData.m_ParserConfig.defaults.find(std::string(update.key));
+  if (default_value == t_ParserData.m_ParserConfig.defaults.end()) {
+    return;
+  }
+  if (!default_value->second.empty()) {
+    section_envir[key_name] = default_value->second[0];
+    return;
+  }
+  section_envir[key_name] = py::none();
+}
+
+// apply the native updates of a section to its python environment
+inline void ApplyUpdates(const std::vector<KeyUpdate> &updates,
+                         const py::dict &section_envir,
+                         const FileData &t_FileData,
+                         const ParserData &t_ParserData) {
+  TypedValues *values = t_FileData.values.get();
+  LoadStats *stats = t_ParserData.stats;
+
+  for (const auto &update : updates) {
+    const py::str key_name = Name(update.key, t_ParserData);
+    switch (update.type) {
+      case UpdateType::SET:
+        section_envir[key_name] = ToPyObject(update.value, values, stats);
+        break;
+      case UpdateType::EXTEND: {
+        PyObject *item = DictItem(section_envir, key_name);
+        py::object list_values =
+            item ? py::reinterpret_borrow<py::object>(item) : py::list();
+        for (const auto &value : std::get<ValueList>(update.value.data)) {
+          list_values.attr("append")(ToPyObject(value, values, stats));
+        }
+        section_envir[key_name] = list_values;
+      } break;
+      case UpdateType::UPDATE: {
+        PyObject *item = DictItem(section_envir, key_name);
+        py::object dict_values =
+            item ? py::reinterpret_borrow<py::object>(item) : py::dict();
+        for (const auto &value : std::get<ValueDict>(update.value.data)) {
+          dict_values[Name(value.first, t_ParserData)] =
+              ToPyObject(value.second, values, stats);
+        }
+        section_envir[key_name] = dict_values;
+      } break;
+      case UpdateType::FALLBACK:
+        ApplyFallback(update, key_name, section_envir, t_FileData,
+                      t_ParserData);
+        break;
     }
+  }
+}
 
-    if (!py::len(section_envir)) {
-      ParseSectionsDefault(t_FileData, t_ParserData, section_envir, true);
+inline py::dict SectionEnvir(const SectionTree &section,
+                             const py::dict &file_envir,
+                             const ParserData &t_ParserData) {
+  switch (section.target) {
+    case SectionTarget::SECTION: {
+      const py::str section_name = Name(section.name, t_ParserData);
+      PyObject *item = DictItem(file_envir, section_name);
+      if (item && PyDict_CheckExact(item)) {
+        return py::reinterpret_borrow<py::dict>(item);
+      }
+      const py::dict section_envir =
+          item ? py::dict(py::reinterpret_borrow<py::object>(item))
+               : py::dict();
+      file_envir[section_name] = section_envir;
+      return section_envir;
     }
+    case SectionTarget::DEFAULT: {
+      py::dict section_envir;
+      file_envir[py::none()] = section_envir;
+      return section_envir;
+    }
+    default:
+      return file_envir;
   }
 }
 
-inline void ParseAllFiles(const ParserData &t_ParserData) {
+// turn the native file tree into python objects (needs the GIL)
+inline void MaterializeFile(const FileTree &tree, const FileData &t_FileData,
+                            const py::dict &file_envir,
+                            const ParserData &t_ParserData) {
+  LoadStats *stats = t_ParserData.stats;
+  const std::uint64_t eval_type =
+      stats ? stats->At(LoadPhase::EVAL_TYPE) : 0;
+  {
+    PhaseTimer timer(stats, LoadPhase::MATERIALIZE);
+    for (const auto &section : tree.sections) {
+      const py::dict section_envir =
+          SectionEnvir(section, file_envir, t_ParserData);
+      ApplyUpdates(section.updates, section_envir, t_FileData, t_ParserData);
+      if (!section.defaults_if_empty.empty() && !py::len(section_envir)) {
+        ApplyUpdates(section.defaults_if_empty, section_envir, t_FileData,
+                     t_ParserData);
+      }
+    }
+  }
+  // eval_type is nested and reported as its own phase
+  if (stats) {
+    stats->At(LoadPhase::MATERIALIZE) -=
+        stats->At(LoadPhase::EVAL_TYPE) - eval_type;
+  }
+}
+
+// counters of a parsed file
+inline void CountFile(const CachedFile &file, const FileTree &tree,
+                      LoadStats *stats) {
+  ++stats->files;
+  stats->bytes += file.index->contents->view().size();
+  stats->sections += tree.sections.size();
+  for (const auto &section : tree.sections) {
+    stats->keys += section.updates.size();
+  }
+}
+
+// file to parse into a file environment (empty path -> empty file)
+struct FileJob {
+  py::dict file_envir;
+  std::string path;
+};
+
+// files to parse (creates the file environments)
+inline std::vector<FileJob> CollectFiles(const ParserData &t_ParserData) {
+  std::vector<FileJob> jobs;
   for (const auto &item : t_ParserData.m_ParserConfig.files) {
     py::dict file_envir;
     if (t_ParserData.m_ParserConfig.files.size() == 1 &&
@@ -373,8 +502,7 @@ inline void ParseAllFiles(const ParserData &t_ParserData) {
     }
 
     if (item.second.empty()) {
-      FileData m_FileData(file_envir, "");
-      t_ParserData.ParseSections(m_FileData, t_ParserData);
+      jobs.push_back({file_envir, ""});
     }
 
     for (std::string item_value : item.second) {
@@ -382,29 +510,261 @@ inline void ParseAllFiles(const ParserData &t_ParserData) {
         continue;
       }
       item_value = system_operations::path_exanduser(item_value);
-      if (!system_operations::file_exists(item_value) &&
-          !string_operations::is_nan(item_value)) {
-        py::object logger = py::module::import("logging");
-        logger.attr("debug")("skipping file '" + item_value +
-                             "', because not exists!");
-        continue;
+      // directories / glob patterns -> matching files in sorted order
+      for (const auto &path : system_operations::expand_path(item_value)) {
+        if (!system_operations::file_exists(path)) {
+          py::object logger = py::module::import("logging");
+          logger.attr("debug")("skipping file '" + path +
+                               "', because not exists!");
+          continue;
+        }
+        jobs.push_back({file_envir, path});
       }
-      FileData m_FileData(file_envir, system_operations::read_file(item_value));
-      t_ParserData.ParseSections(m_FileData, t_ParserData);
     }
   }
+  return jobs;
+}
+
+// load defaults if no file exists / providing
+inline void ParseDefaultsOnly(const ParserData &t_ParserData) {
+  if (!t_ParserData.m_ParserConfig.envir.empty()) return;
 
-  // load defaults if no file exists / providing
-  if (t_ParserData.m_ParserConfig.envir.empty()) {
-    py::object logger = py::module::import("logging");
-    logger.attr("debug")(
-        "no sections or files to load, loading default values only.");
-    py::dict file_envir = t_ParserData.m_ParserConfig.envir;
-    FileData m_FileData(file_envir, "");
-    ParseSectionsDefault(m_FileData, t_ParserData, file_envir, true);
+  py::object logger = py::module::import("logging");
+  logger.attr("debug")(
+      "no sections or files to load, loading default values only.");
+  FileData m_FileData(EmptyFile());
+  m_FileData.schema = t_ParserData.schema.get();
+  FileTree tree;
+  ParseSectionsDefault(m_FileData, t_ParserData,
+                       &AddSection(&tree, SectionTarget::FILE)->updates, true);
+  MaterializeFile(tree, m_FileData, t_ParserData.m_ParserConfig.envir,
+                  t_ParserData);
+}
+
+// source files of an image (parsed contents, skipped files as missing,
+// matches of directories / glob patterns as listing)
+inline std::vector<ImageSource> ImageSources(
+    const ParserData &t_ParserData, const std::vector<FileJob> &jobs,
+    const std::vector<CachedFile> &files,
+    const std::vector<ImageSource> &reads) {
+  std::vector<ImageSource> sources;
+  for (const auto &item : t_ParserData.m_ParserConfig.files) {
+    for (std::string pattern : item.second) {
+      if (string_operations::is_nan(pattern)) continue;
+      pattern = system_operations::path_exanduser(pattern);
+      const auto paths = system_operations::expand_path(pattern);
+      if (paths.size() != 1 || paths[0] != pattern) {
+        sources.push_back(
+            {pattern, ImageSourceType::LISTING, ListingHash(paths), {}, 0});
+      }
+
+      for (const auto &path : paths) {
+        ImageSource source{path, ImageSourceType::MISSING, 0, {}, 0};
+        for (std::size_t idx = 0; idx < jobs.size(); ++idx) {
+          if (jobs[idx].path != path) continue;
+          source.type = ImageSourceType::CONTENTS;
+          source.hash = ContentHash(files[idx].index->contents->view());
+          source.stat = reads[idx].stat;
+          source.read_ns = reads[idx].read_ns;
+          break;
+        }
+        sources.push_back(std::move(source));
+      }
+    }
+  }
+  return sources;
+}
+
+inline void ParseAllFiles(const ParserData &t_ParserData,
+                          std::vector<ImageSource> *sources = nullptr) {
+  const std::vector<FileJob> jobs = CollectFiles(t_ParserData);
+
+  // read, tokenize and parse into native trees in parallel (without GIL),
+  // evicted cache entries and results hold python objects -> destroyed after
+  // the GIL is reacquired
+  std::vector<CachedFile> files(jobs.size());
+  std::vector<FileTree> trees(jobs.size());
+  std::vector<std::vector<CachedFile>> released(jobs.size());
+  // per file (threads), merged afterwards
+  std::vector<LoadStats> stats(t_ParserData.stats ? jobs.size() : 0);
+  // stat / time before the read (image sources hash only changed files)
+  std::vector<ImageSource> reads(sources ? jobs.size() : 0);
+  {
+    py::gil_scoped_release release;
+    system_operations::parallel_for(jobs.size(), [&](std::size_t idx) {
+      LoadStats *file_stats = stats.empty() ? nullptr : &stats[idx];
+      if (sources && !jobs[idx].path.empty()) {
+        reads[idx].read_ns = WallClockNs();
+        system_operations::file_stat(jobs[idx].path, &reads[idx].stat);
+      }
+      files[idx] = jobs[idx].path.empty()
+                       ? EmptyFile()
+                       : LoadFile(jobs[idx].path, &released[idx],
+                                  t_ParserData.multiline, file_stats);
+      {
+        PhaseTimer timer(file_stats, LoadPhase::PARSE);
+        ParseFile(files[idx], t_ParserData, &trees[idx]);
+      }
+      if (file_stats && !jobs[idx].path.empty()) {
+        CountFile(files[idx], trees[idx], file_stats);
+      }
+    });
+  }
+  for (const auto &item : stats) t_ParserData.stats->Merge(item);
+
+  // materialize in order of the files
+  for (std::size_t idx = 0; idx < jobs.size(); ++idx) {
+    MaterializeFile(trees[idx], FileData(files[idx]), jobs[idx].file_envir,
+                    t_ParserData);
+  }
+  if (sources) {
+    PhaseTimer timer(t_ParserData.stats, LoadPhase::IMAGE);
+    *sources = ImageSources(t_ParserData, jobs, files, reads);
+  }
+
+  ParseDefaultsOnly(t_ParserData);
+}
+
+// Controller (parse functions for the selected sections / keys)
+inline ParserData CreateParserData(
+    const std::map<std::string, std::vector<std::string>> &files,
+    const Selection &selection,
+    const std::map<std::string, std::vector<py::object>> &defaults,
+    const py::dict &envir,
+    const std::shared_ptr<const system_operations::Environment> &environment) {
+  switch (!selection.sections().empty() * 1 + !selection.keys().empty() * 2) {
+    case 1:
+      return ParserData(ParseDefinedSections, ParseAllKeys,
+                        ParserConfig(files, selection, defaults, envir),
+                        environment);
+    case 2:
+      return ParserData(ParseAllSections, ParseDefinedKeys,
+                        ParserConfig(files, selection, defaults, envir),
+                        environment);
+    case 3:
+      return ParserData(ParseDefinedSections, ParseDefinedKeys,
+                        ParserConfig(files, selection, defaults, envir),
+                        environment);
+    default:
+      return ParserData(ParseAllSections, ParseAllKeys,
+                        ParserConfig(files, selection, defaults, envir),
+                        environment);
+  }
+}
+
+inline std::shared_ptr<const system_operations::Environment> EvalEnvironment(
+    const bool &eval_env,
+    std::shared_ptr<const system_operations::Environment> environment) {
+  if (!eval_env) return nullptr;
+  if (!environment) {
+    environment = std::make_shared<const system_operations::Environment>();
+  }
+  return environment;
+}
+
+// arguments an image was loaded with (images are only reused for the same)
+inline std::string ImageKey(
+    const std::map<std::string, std::vector<std::string>> &files,
+    const Selection &selection,
+    const std::map<std::string, std::vector<py::object>> &defaults,
+    const bool &multiline, const Schema *schema) {
+  std::string key(multiline ? "multiline" : "");
+  const auto add = [&key](const std::string &value) {
+    key += std::to_string(value.size()) + ':' + value;
+  };
+  for (const auto &item : files) {
+    add(item.first);
+    for (const auto &path : item.second) add(path);
+  }
+  key += '|';
+  for (const auto &section : selection.sections()) {
+    add(section.name);
+    for (const auto &name : section.sections) add(name.name);
+  }
+  key += '|';
+  for (const auto &item : selection.keys()) {
+    add(item.name);
+    for (const auto &alias : item.aliases) add(alias.name);
+  }
+  key += '|';
+  for (const auto &item : defaults) {
+    add(item.first);
+    for (const auto &value : item.second) add(py::repr(value));
+  }
+  key += '|';
+  if (schema) key += schema->key();
+  return key;
+}
+
+// parse into the environment of the parser data, the image is rebuilt if
+// enabled (image_path not empty)
+inline void ParseEnvir(ParserData *t_ParserData, const std::string &image_path,
+                       const std::string &image_key, LoadStats *stats) {
+  PyNames names;  // per load (unless kept by the parser)
+  if (!t_ParserData->names) t_ParserData->names = &names;
+  t_ParserData->stats = stats;
+  std::vector<ImageSource> sources;
+  ParseAllFiles(*t_ParserData, image_path.empty() ? nullptr : &sources);
+  t_ParserData->stats = nullptr;
+  if (t_ParserData->names == &names) t_ParserData->names = nullptr;
+  if (!image_path.empty()) {
+    PhaseTimer timer(stats, LoadPhase::IMAGE);
+    WriteImage(image_path, image_key, sources,
+               t_ParserData->m_ParserConfig.envir);
   }
 }
 
+/// This is a simple (lightweight) C++ function to parse ini file into python
+///
+/// @param files vector of string with files to read (directories -> their
+/// *.ini files, glob patterns -> matching files, merged in sorted order)
+/// @param selection compiled sections / keys (see ini::Selection)
+/// @param defaults vector of python objects for default values
+/// @param eval_env use environment variables for missing keys
+/// @param environment long-lived environment snapshot (nullptr -> snapshot
+/// per call)
+/// @param image binary image of the typed result, reused while the source
+/// files are unchanged and rebuilt otherwise (empty -> no image, not used
+/// with eval_env / interpolate)
+/// @param interpolate substitute ${section:key} / ${key} / ${ENV}
+/// references before the values are typed
+/// @param multiline join indented continuation lines and lines ending with
+/// a backslash into their values
+/// @param schema key types, typed keys are converted into their type
+/// without the eval_type inference (nullptr -> inference only)
+/// @param stats collects the nanoseconds per phase and the counters of the
+/// call (nullptr -> disabled)
+/// @returns environment(s) with configs
+py::dict ini_load(
+    const std::map<std::string, std::vector<std::string>> &files,
+    const Selection &selection,
+    const std::map<std::string, std::vector<py::object>> &defaults,
+    const bool &eval_env,
+    std::shared_ptr<const system_operations::Environment> environment,
+    const std::string &image, const bool &interpolate, const bool &multiline,
+    std::shared_ptr<const Schema> schema, LoadStats *stats) {
+  py::dict envir;
+  const bool use_image = !image.empty() && !eval_env && !interpolate;
+  std::string image_path, image_key;
+  if (use_image) {
+    PhaseTimer timer(stats, LoadPhase::IMAGE);
+    image_path = system_operations::path_exanduser(image);
+    image_key = ImageKey(files, selection, defaults, multiline, schema.get());
+    if (ReadImage(image_path, image_key, &envir)) return envir;
+  }
+
+  ParserData m_ParserData =
+      CreateParserData(files, selection, defaults, envir,
+                       EvalEnvironment(eval_env, environment));
+  if (interpolate) {
+    m_ParserData.interpolation = EvalEnvironment(true, std::move(environment));
+  }
+  m_ParserData.multiline = multiline;
+  m_ParserData.schema = std::move(schema);
+  ParseEnvir(&m_ParserData, image_path, image_key, stats);
+  return envir;
+}
+
 /// This is a simple (lightweight) C++ function to parse ini file into python
 ///
 /// @param files vector of string with files to read
@@ -418,47 +778,268 @@ py::dict ini_load(
     const std::map<std::string, std::vector<std::string>> &keys,
     const std::map<std::string, std::vector<py::object>> &defaults,
     const bool &eval_env = false) {
-  py::dict envir;
+  return ini_load(files, Selection(sections, keys), defaults, eval_env,
+                  nullptr, "", false, false, nullptr);
+}
 
-  // Controller
-  switch (!sections.empty() * 1 + !keys.empty() * 2) {
-    case 0: {
-      ParseAllFiles(ParserData(ParseAllSections, ParseAllKeys,
-                               ParserConfig(files,
-                                            // vector of strings (keys + names)
-                                            {},  // sections && section_names
-                                            {},  // keys && key_names
-                                            defaults, envir),
-                               eval_env));
-    } break;
-    case 1: {
-      ParseAllFiles(ParserData(ParseDefinedSections, ParseAllKeys,
-                               ParserConfig(files,
-                                            // vector of strings (keys + names)
-                                            sections,  // sections
-                                            {},        // keys && key_names
-                                            defaults, envir),
-                               eval_env));
-    } break;
-    case 2: {
-      ParseAllFiles(ParserData(ParseAllSections, ParseDefinedKeys,
-                               ParserConfig(files,
-                                            // vector of strings (keys + names)
-                                            {},  // sections && section_names
-                                            keys, defaults, envir),
-                               eval_env));
-    } break;
-    case 3: {
-      ParseAllFiles(ParserData(ParseDefinedSections, ParseDefinedKeys,
-                               ParserConfig(files,
-                                            // vector of strings (keys + names)
-                                            sections,  // sections
-                                            keys, defaults, envir),
-                               eval_env));
-    } break;
+// changed paths between two environments (nested dicts are compared by key)
+inline void DiffEnvir(const py::dict &previous, const py::dict &current,
+                      std::vector<py::object> *path, py::list *changes) {
+  const auto add_change = [&](const py::handle &key) {
+    path->push_back(py::reinterpret_borrow<py::object>(key));
+    changes->append(py::tuple(py::cast(*path)));
+    path->pop_back();
+  };
+
+  for (const auto &item : previous) {
+    if (!current.contains(item.first)) {
+      add_change(item.first);
+      continue;
+    }
+    const py::object value = current[item.first];
+    if (py::isinstance<py::dict>(item.second) &&
+        py::isinstance<py::dict>(value)) {
+      path->push_back(py::reinterpret_borrow<py::object>(item.first));
+      DiffEnvir(py::reinterpret_borrow<py::dict>(item.second),
+                py::reinterpret_borrow<py::dict>(value), path, changes);
+      path->pop_back();
+    } else if (!value.equal(item.second)) {
+      add_change(item.first);
+    }
+  }
+  for (const auto &item : current) {
+    if (!previous.contains(item.first)) add_change(item.first);
+  }
+}
+
+/// Reusable ini_load, the parse functions, compiled selection, defaults,
+/// environment snapshot and image key are created once and section / key
+/// names are shared between the calls
+///
+/// @param files vector of string with files to read (directories / glob
+/// patterns are expanded on every load)
+/// @param selection compiled sections / keys (see ini::Selection)
+/// @param defaults vector of python objects for default values
+/// @param eval_env use environment variables for missing keys
+/// @param environment long-lived environment snapshot (nullptr -> snapshot
+/// per parser)
+/// @param image binary image of the typed result (see ini_load)
+/// @param interpolate substitute ${section:key} / ${key} / ${ENV} references
+/// @param multiline join continuation lines into their values
+/// @param schema key types (see ini_load)
+Parser::Parser(
+    const std::map<std::string, std::vector<std::string>> &files,
+    const Selection &selection,
+    const std::map<std::string, std::vector<py::object>> &defaults,
+    const bool &eval_env,
+    std::shared_ptr<const system_operations::Environment> environment,
+    const std::string &image, const bool &interpolate, const bool &multiline,
+    std::shared_ptr<const Schema> schema)
+    : m_names(std::make_unique<PyNames>()) {
+  m_ParserData = std::make_shared<ParserData>(
+      CreateParserData(files, selection, defaults, py::dict(),
+                       EvalEnvironment(eval_env, environment)));
+  if (interpolate) {
+    m_ParserData->interpolation = EvalEnvironment(true, std::move(environment));
+  }
+  m_ParserData->multiline = multiline;
+  m_ParserData->names = m_names.get();
+  if (!image.empty() && !eval_env && !interpolate) {
+    m_image_path = system_operations::path_exanduser(image);
+    m_image_key =
+        ImageKey(files, selection, defaults, multiline, schema.get());
   }
+  m_ParserData->schema = std::move(schema);
+}
 
+Parser::~Parser() = default;
+
+/// Load the files into a new environment (same result as ini_load)
+///
+/// @param stats collects the nanoseconds per phase and the counters of the
+/// call (nullptr -> disabled)
+/// @returns environment(s) with configs
+py::dict Parser::load(LoadStats *stats) {
+  py::dict envir;
+  if (!m_image_path.empty()) {
+    PhaseTimer timer(stats, LoadPhase::IMAGE);
+    if (ReadImage(m_image_path, m_image_key, &envir)) return envir;
+  }
+  m_ParserData->m_ParserConfig.envir = envir;
+  ParseEnvir(m_ParserData.get(), m_image_path, m_image_key, stats);
+  m_ParserData->m_ParserConfig.envir = py::dict();  // owned by the caller
   return envir;
 }
 
+Reloader::Reloader(
+    std::map<std::string, std::vector<std::string>> t_files,
+    Selection t_selection,
+    std::map<std::string, std::vector<py::object>> t_defaults,
+    const bool &eval_env,
+    std::shared_ptr<const system_operations::Environment> environment)
+    : m_files(std::move(t_files)),
+      m_selection(std::move(t_selection)),
+      m_defaults(std::move(t_defaults)),
+      m_environment(EvalEnvironment(eval_env, std::move(environment))) {
+  reload();
+}
+
+/// Reload all files, unchanged files (same identity or same contents) keep
+/// their parse state, the environment snapshot is kept between reloads.
+/// Changed and racy files (see IsRacy) are read without the file cache and
+/// compared by their contents.
+///
+/// @returns list of changed paths (tuples of keys), empty if nothing changed
+py::list Reloader::reload() {
+  py::dict envir;
+  PyNames names;
+  ParserData m_ParserData = CreateParserData(m_files, m_selection, m_defaults,
+                                             envir, m_environment);
+  m_ParserData.names = &names;
+  const std::vector<FileJob> jobs = CollectFiles(m_ParserData);
+
+  // a path may be used by several file environments -> parsed once
+  std::unordered_map<std::string, ReloadFile> state;
+  std::vector<std::pair<const std::string *, ReloadFile *>> paths;
+  for (const auto &job : jobs) {
+    const auto state_iter = state.emplace(job.path, ReloadFile());
+    if (!state_iter.second) continue;
+    const auto previous = m_state.find(job.path);
+    if (previous != m_state.end()) state_iter.first->second = previous->second;
+    paths.emplace_back(&state_iter.first->first, &state_iter.first->second);
+  }
+
+  std::vector<char> changed(paths.size(), 0);
+  {
+    py::gil_scoped_release release;
+    system_operations::parallel_for(paths.size(), [&](std::size_t idx) {
+      const std::string &path = *paths[idx].first;
+      ReloadFile &file = *paths[idx].second;
+      system_operations::FileStat stat;
+      const bool is_file = !path.empty() &&
+                           system_operations::file_stat(path, &stat) &&
+                           stat.is_regular;
+      if (file.tree && is_file && stat == file.stat &&
+          !IsRacy(stat, file.read_ns)) {
+        return;
+      }
+      // read directly: a cache entry can hide a rewrite that kept the stat
+      const std::int64_t read_ns = WallClockNs();
+      const auto contents =
+          path.empty()
+              ? std::make_shared<const system_operations::FileBuffer>()
+              : system_operations::map_file(path, true);
+      const std::size_t hash =
+          std::hash<std::string_view>()(contents->view());
+      file.stat = stat;
+      file.read_ns = read_ns;
+      if (file.tree && file.hash == hash) return;
+
+      CachedFile cached = TokenizeContents(contents);
+      auto tree = std::make_shared<FileTree>();
+      ParseFile(cached, m_ParserData, tree.get());
+      file.hash = hash;
+      file.file = std::move(cached);
+      file.tree = std::move(tree);
+      changed[idx] = 1;
+    });
+  }
+
+  const bool is_changed =
+      !m_is_loaded || state.size() != m_state.size() ||
+      std::find(changed.begin(), changed.end(), 1) != changed.end() ||
+      std::any_of(state.begin(), state.end(), [&](const auto &item) {
+        return m_state.find(item.first) == m_state.end();
+      });
+  m_state = std::move(state);
+  if (!is_changed) return py::list();
+
+  // materialize in order of the files
+  for (const auto &job : jobs) {
+    const ReloadFile &file = m_state[job.path];
+    MaterializeFile(*file.tree, FileData(file.file), job.file_envir,
+                    m_ParserData);
+  }
+  ParseDefaultsOnly(m_ParserData);
+
+  py::list changes;
+  std::vector<py::object> path;
+  DiffEnvir(m_result, envir, &path, &changes);
+  m_result = envir;
+  m_is_loaded = true;
+  return changes;
+}
+
+/// Stream the sections of a single ini file (bounded memory)
+///
+/// @param path ini file to read
+/// @param selection compiled sections / keys, sections only filter the file
+/// sections (no renaming / merging)
+/// @param defaults vector of python objects for default values
+/// @param eval_env use environment variables for missing keys
+/// @param environment long-lived environment snapshot (nullptr -> snapshot
+/// per stream)
+/// @param chunk_size bytes read at once
+SectionStream::SectionStream(
+    const std::string &path, const Selection &selection,
+    const std::map<std::string, std::vector<py::object>> &defaults,
+    const bool &eval_env,
+    std::shared_ptr<const system_operations::Environment> environment,
+    std::size_t chunk_size)
+    : m_reader(system_operations::path_exanduser(path), chunk_size),
+      m_names(std::make_unique<PyNames>()) {
+  // sections are filtered while streaming, ParseAllSections parses the rest
+  auto m_data = std::make_shared<ParserData>(
+      ParseAllSections,
+      selection.keys().empty() ? ParseAllKeys : ParseDefinedKeys,
+      ParserConfig({}, selection, defaults, py::dict()),
+      EvalEnvironment(eval_env, std::move(environment)));
+  m_data->names = m_names.get();
+  m_ParserData = std::move(m_data);
+  for (const auto &target : selection.sections()) {
+    for (const auto &section : target.sections) {
+      if (!section.is_nan) m_sections.insert(section.name);
+    }
+  }
+}
+
+/// Next section of the file
+///
+/// @returns tuple of section name (None before the first section) and
+/// section environment, raises StopIteration at the end of the file
+py::tuple SectionStream::next() {
+  std::string contents;
+  CachedFile file;
+  FileTree tree;
+  {
+    py::gil_scoped_release release;
+    while (m_reader.Next(&contents)) {
+      // selected sections only (the part before the first section too)
+      if (!m_sections.empty() &&
+          !m_sections.count(std::string(SectionName(contents)))) {
+        continue;
+      }
+      file = {TokenizeFile(
+                  std::make_shared<const system_operations::FileBuffer>(
+                      std::move(contents))),
+              std::make_shared<TypedValues>()};
+      // nothing but comments / blank lines before the first section
+      if (file.index->sections.empty() && file.index->entries.empty()) {
+        file = {};
+        continue;
+      }
+      ParseFile(file, *m_ParserData, &tree);
+      break;
+    }
+  }
+  if (!file.index) throw py::stop_iteration();
+
+  py::dict file_envir;
+  MaterializeFile(tree, FileData(file), file_envir, *m_ParserData);
+  for (const auto &item : file_envir) {
+    return py::make_tuple(item.first, item.second);
+  }
+  throw py::stop_iteration();
+}
+
 }  // namespace ini
@@ -5,28 +5,119 @@
 // clang-format off
 #include <algorithm>
 #include <complex>
+#include <deque>
+#include <functional>
 #include <map>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
+#include <ini_cache.hpp>
+#include <ini_image.hpp>
+#include <ini_interpolation.hpp>
+#include <ini_selection.hpp>
+#include <ini_stats.hpp>
+#include <ini_stream.hpp>
+#include <ini_tree.hpp>
+#include <ini_tokenizer.hpp>
 #include <string_operations.hpp>
 #include <system_operations.hpp>
 // clang-format on
 
 namespace ini {  // cppcheck-suppress syntaxError
-// constants
-inline const char COMMENT_CHAR = '#';
-inline const char NEWVALUE = '=';
-inline const char WHITESPACE = ' ';
-inline const std::string SECTION_OPEN_CHAR = "[";
-inline const std::string SECTION_CLOSE_CHAR = "]";
-inline const std::string BEGIN_PATTERN = '\n' + SECTION_OPEN_CHAR;
 py::dict ini_load(
     const std::map<std::string, std::vector<std::string>> &files,
     const std::map<std::string, std::vector<std::string>> &sections,
     const std::map<std::string, std::vector<std::string>> &keys,
     const std::map<std::string, std::vector<py::object>> &defaults,
     const bool &eval_env);
+py::dict ini_load(
+    const std::map<std::string, std::vector<std::string>> &files,
+    const Selection &selection,
+    const std::map<std::string, std::vector<py::object>> &defaults,
+    const bool &eval_env,
+    std::shared_ptr<const system_operations::Environment> environment,
+    const std::string &image = "", const bool &interpolate = false,
+    const bool &multiline = false,
+    std::shared_ptr<const Schema> schema = nullptr,
+    LoadStats *stats = nullptr);
+
+struct ParserData;
+
+// Reusable ini_load (parser context created once, loaded many times)
+class Parser {
+ public:
+  Parser(const std::map<std::string, std::vector<std::string>> &files,
+         const Selection &selection,
+         const std::map<std::string, std::vector<py::object>> &defaults,
+         const bool &eval_env,
+         std::shared_ptr<const system_operations::Environment> environment,
+         const std::string &image = "", const bool &interpolate = false,
+         const bool &multiline = false,
+         std::shared_ptr<const Schema> schema = nullptr);
+  ~Parser();
+  py::dict load(LoadStats *stats = nullptr);
+
+ private:
+  std::shared_ptr<ParserData> m_ParserData;
+  std::unique_ptr<PyNames> m_names;  // section / key names between the loads
+  std::string m_image_path;                  // empty -> no image
+  std::string m_image_key;
+};
+
+// Parse state of a file between reloads
+struct ReloadFile {
+  system_operations::FileStat stat;
+  std::int64_t read_ns = 0;  // wall clock before the contents were read
+  std::size_t hash = 0;      // hash of the contents
+  CachedFile file;
+  std::shared_ptr<const FileTree> tree;
+};
+
+// Incremental ini_load: files are only re-parsed when their contents change,
+// reload() returns the paths of changed / added / removed values
+class Reloader {
+ public:
+  Reloader(std::map<std::string, std::vector<std::string>> t_files,
+           Selection t_selection,
+           std::map<std::string, std::vector<py::object>> t_defaults,
+           const bool &eval_env,
+           std::shared_ptr<const system_operations::Environment> environment);
+  py::list reload();
+  py::dict result() const { return m_result; }
+
+ private:
+  std::map<std::string, std::vector<std::string>> m_files;
+  Selection m_selection;
+  std::map<std::string, std::vector<py::object>> m_defaults;
+  std::shared_ptr<const system_operations::Environment> m_environment;
+  std::unordered_map<std::string, ReloadFile> m_state;  // path -> state
+  py::dict m_result;
+  bool m_is_loaded = false;
+};
+
+// Section by section ini_load of a single (large) file, only the current
+// section is held in memory
+class SectionStream {
+ public:
+  SectionStream(const std::string &path, const Selection &selection,
+                const std::map<std::string, std::vector<py::object>> &defaults,
+                const bool &eval_env,
+                std::shared_ptr<const system_operations::Environment>
+                    environment,
+                std::size_t chunk_size = STREAM_CHUNK_SIZE);
+  py::tuple next();
+  std::uint64_t offset() const { return m_reader.offset(); }
+
+ private:
+  SectionReader m_reader;
+  std::shared_ptr<const ParserData> m_ParserData;
+  std::unique_ptr<PyNames> m_names;  // section / key names between sections
+  std::unordered_set<std::string> m_sections;  // empty -> all sections
+};
 }  // namespace ini
 
 #endif  // INST__CORNFLAKES_INI_HPP_
@@ -0,0 +1,203 @@
+// Copyright (c) 2022 Semjon Geist.
+#include <ini_cache.hpp>
+
+#include <chrono>
+
+//! Process wide cache of tokenized ini files and their typed values
+namespace ini {
+
+inline bool IsImmutable(const py::object &value) {
+  return value.is_none() || PyUnicode_CheckExact(value.ptr()) ||
+         PyLong_CheckExact(value.ptr()) || PyFloat_CheckExact(value.ptr()) ||
+         PyBool_Check(value.ptr());
+}
+
+/// Evaluate the type of a value (memoized for immutable results)
+///
+/// @param value view into the file contents
+/// @returns typed python object
+py::object TypedValues::Eval(const std::string_view &value) {
+  const auto value_iter = values.find(value);
+  if (value_iter != values.end()) return value_iter->second;
+
+  py::object result = string_operations::eval_type(std::string(value));
+  if (IsImmutable(result)) values.emplace(value, result);
+  return result;
+}
+
+inline std::shared_ptr<const system_operations::FileBuffer> ReadCachedFile(
+    const std::string &path, LoadStats *stats) {
+  PhaseTimer timer(stats, LoadPhase::READ);
+  // owned: the contents outlive the call (cache entries, value trees)
+  return system_operations::map_file(path, true);
+}
+
+/// Tokenize file contents without the cache (new typed values)
+///
+/// @param contents owned file contents
+/// @param multiline join continuation lines
+/// @param stats timings of ini_load (nullptr -> not collected)
+/// @returns tokenized file with typed values
+CachedFile TokenizeContents(
+    std::shared_ptr<const system_operations::FileBuffer> contents,
+    const bool &multiline, LoadStats *stats) {
+  PhaseTimer timer(stats, LoadPhase::TOKENIZE);
+  return {TokenizeFile(std::move(contents), multiline),
+          std::make_shared<TypedValues>()};
+}
+
+/// Wall clock (comparable with the mtime of files)
+///
+/// @returns nanoseconds since the epoch
+std::int64_t WallClockNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+FileCache &FileCache::instance() {
+  static FileCache cache;
+  return cache;
+}
+
+// entry of path that still holds file (end -> replaced / evicted meanwhile)
+std::list<FileCache::Entry>::iterator FileCache::Find(const std::string &path,
+                                                      const CachedFile &file) {
+  const auto entry_iter = lookup.find(path);
+  if (entry_iter == lookup.end() ||
+      entry_iter->second->file.index != file.index) {
+    return entries.end();
+  }
+  return entry_iter->second;
+}
+
+/// Load a file through the cache (pipes, procfs and empty files are not
+/// cached, because their identity does not change with the contents).
+/// Entries of files modified within CACHE_RACY_WINDOW_NS of their read are
+/// only reused if the contents are unchanged (an in-place rewrite of the same
+/// size within the mtime granularity keeps the stat).
+///
+/// @param path path of an existing file
+/// @param released evicted entries (must be destroyed with the GIL held)
+/// @param multiline join continuation lines (entries tokenized otherwise are
+/// replaced)
+/// @param stats timings / counters of ini_load (nullptr -> not collected)
+/// @returns tokenized file with typed values
+CachedFile FileCache::Load(const std::string &path,
+                           std::vector<CachedFile> *released,
+                           const bool &multiline, LoadStats *stats) {
+  system_operations::FileStat stat;
+  if (!system_operations::file_stat(path, &stat) || !stat.is_regular ||
+      !stat.size) {
+    return TokenizeContents(ReadCachedFile(path, stats), multiline, stats);
+  }
+
+  CachedFile racy;  // matching entry that has to be confirmed
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto entry_iter = lookup.find(path);
+    if (entry_iter != lookup.end()) {
+      Entry &entry = *entry_iter->second;
+      if (entry.stat == stat && entry.file.index->multiline == multiline) {
+        if (!IsRacy(stat, entry.read_ns)) {
+          ++info.hits;
+          if (stats) ++stats->cache_hits;
+          entries.splice(entries.begin(), entries, entry_iter->second);
+          return entry.file;
+        }
+        racy = entry.file;
+      } else {
+        // file changed -> replace entry
+        released->push_back(std::move(entry.file));
+        entries.erase(entry_iter->second);
+        lookup.erase(entry_iter);
+        ++info.evictions;
+      }
+    }
+  }
+
+  const std::int64_t read_ns = WallClockNs();
+  auto contents = ReadCachedFile(path, stats);
+  if (racy.index && contents->view() == racy.index->contents->view()) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++info.hits;
+    if (stats) ++stats->cache_hits;
+    const auto entry_iter = Find(path, racy);
+    if (entry_iter != entries.end()) {
+      entry_iter->read_ns = read_ns;  // confirmed (racy until the window ends)
+      entries.splice(entries.begin(), entries, entry_iter);
+    }
+    return racy;
+  }
+
+  CachedFile file = TokenizeContents(std::move(contents), multiline, stats);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  ++info.misses;
+  if (racy.index) {
+    // rewritten without changing the stat -> replace entry
+    const auto entry_iter = Find(path, racy);
+    if (entry_iter != entries.end()) {
+      released->push_back(std::move(entry_iter->file));
+      lookup.erase(path);
+      entries.erase(entry_iter);
+      ++info.evictions;
+    }
+    released->push_back(std::move(racy));
+  }
+  if (lookup.find(path) == lookup.end()) {
+    entries.push_front({stat, read_ns, file});
+    lookup.emplace(path, entries.begin());
+    while (entries.size() > info.max_size) {
+      lookup.erase(entries.back().stat.path);
+      released->push_back(std::move(entries.back().file));
+      entries.pop_back();
+      ++info.evictions;
+    }
+  }
+  return file;
+}
+
+CacheInfo FileCache::Info() {
+  std::lock_guard<std::mutex> lock(mutex);
+  CacheInfo result = info;
+  result.size = entries.size();
+  return result;
+}
+
+void FileCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex);
+  lookup.clear();
+  entries.clear();
+  info = CacheInfo();
+}
+
+CachedFile LoadFile(const std::string &path,
+                    std::vector<CachedFile> *released, const bool &multiline,
+                    LoadStats *stats) {
+  return FileCache::instance().Load(path, released, multiline, stats);
+}
+
+CachedFile EmptyFile() {
+  return TokenizeContents(
+      std::make_shared<const system_operations::FileBuffer>());
+}
+
+/// Statistics of the ini file cache
+///
+/// @returns dict with hits, misses, evictions, size and max_size
+py::dict ini_cache_info() {
+  const CacheInfo info = FileCache::instance().Info();
+  py::dict result;
+  result["hits"] = info.hits;
+  result["misses"] = info.misses;
+  result["evictions"] = info.evictions;
+  result["size"] = info.size;
+  result["max_size"] = info.max_size;
+  return result;
+}
+
+/// Drop all cached ini files and reset the statistics
+void ini_cache_clear() { FileCache::instance().Clear(); }
+
+}  // namespace ini
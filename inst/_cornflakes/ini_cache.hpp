@@ -0,0 +1,98 @@
+// Copyright (c) 2022 Semjon Geist.
+#ifndef INST__CORNFLAKES_INI_CACHE_HPP_
+#define INST__CORNFLAKES_INI_CACHE_HPP_
+
+// clang-format off
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <ini_stats.hpp>
+#include <ini_tokenizer.hpp>
+#include <string_operations.hpp>
+#include <system_operations.hpp>
+// clang-format on
+
+namespace ini {  // cppcheck-suppress syntaxError
+inline const std::size_t CACHE_MAX_SIZE = 64;
+// files modified within this window of their read can change again without
+// changing their stat (mtime granularity), their entries are confirmed by
+// comparing the contents
+inline const std::int64_t CACHE_RACY_WINDOW_NS = 1000000000;
+
+// Typed values (eval_type) of a file, only immutable python objects are
+// memoized. Only used with the GIL held.
+class TypedValues {
+ public:
+  py::object Eval(const std::string_view &value);
+
+ private:
+  std::unordered_map<std::string_view, py::object> values;
+};
+
+// Tokenized file + typed values (views point into index->contents)
+struct CachedFile {
+  std::shared_ptr<const FileIndex> index;
+  std::shared_ptr<TypedValues> values;
+};
+
+struct CacheInfo {
+  std::size_t hits = 0;
+  std::size_t misses = 0;
+  std::size_t evictions = 0;
+  std::size_t size = 0;
+  std::size_t max_size = CACHE_MAX_SIZE;
+};
+
+// Process wide LRU cache of parsed files (keyed by path, validated by mtime,
+// size, inode and device, racy entries additionally by their contents). Load
+// is thread safe and does not touch python objects, evicted entries are
+// handed to the caller (released with the GIL).
+class FileCache {
+ public:
+  static FileCache &instance();
+  CachedFile Load(const std::string &path, std::vector<CachedFile> *released,
+                  const bool &multiline, LoadStats *stats);
+  CacheInfo Info();
+  void Clear();
+
+ private:
+  struct Entry {
+    system_operations::FileStat stat;
+    std::int64_t read_ns;  // wall clock before the contents were read
+    CachedFile file;
+  };
+  std::list<Entry>::iterator Find(const std::string &path,
+                                  const CachedFile &file);
+  std::mutex mutex;
+  std::list<Entry> entries;  // most recently used first
+  std::unordered_map<std::string, std::list<Entry>::iterator> lookup;
+  CacheInfo info;
+};
+
+// a rewrite within the mtime granularity after read_ns can keep the stat
+inline bool IsRacy(const system_operations::FileStat &stat,
+                   const std::int64_t &read_ns) {
+  return stat.mtime_ns + CACHE_RACY_WINDOW_NS > read_ns;
+}
+
+std::int64_t WallClockNs();
+CachedFile TokenizeContents(
+    std::shared_ptr<const system_operations::FileBuffer> contents,
+    const bool &multiline = false, LoadStats *stats = nullptr);
+CachedFile LoadFile(const std::string &path,
+                    std::vector<CachedFile> *released,
+                    const bool &multiline = false,
+                    LoadStats *stats = nullptr);
+CachedFile EmptyFile();
+py::dict ini_cache_info();
+void ini_cache_clear();
+}  // namespace ini
+
+#endif  // INST__CORNFLAKES_INI_CACHE_HPP_
@@ -0,0 +1,410 @@
+// Copyright (c) 2022 Semjon Geist.
+#include <ini_image.hpp>
+#include <ini_cache.hpp>
+#include <py_types.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+
+//! Binary images of typed ini_load results (skip parsing unchanged files)
+namespace ini {
+enum class ImageTag : std::uint8_t {
+  NONE,
+  TRUE,
+  FALSE,
+  INT,
+  FLOAT,
+  STR,
+  LIST,
+  DICT,
+  BIG_INT,   // int beyond 64 bit (little endian two's complement)
+  DATETIME,  // datetime / date / time (DateTimeFields)
+  DECIMAL,   // str(value), rebuilt by the type
+  UUID,
+  IPV4,
+  IPV6,
+};
+
+// nested lists / dicts (deeper values are not encoded / invalid images)
+inline const std::size_t IMAGE_MAX_DEPTH = 256;
+
+template <typename T>
+inline void WriteRaw(const T &value, std::string *out) {
+  out->append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+inline void WriteString(const std::string_view &value, std::string *out) {
+  WriteRaw(static_cast<std::uint64_t>(value.size()), out);
+  out->append(value.data(), value.size());
+}
+
+inline void WriteTag(const ImageTag &tag, std::string *out) {
+  WriteRaw(static_cast<std::uint8_t>(tag), out);
+}
+
+// bounds checked reader of a mapped image (malformed -> runtime_error)
+class ImageReader {
+ public:
+  explicit ImageReader(std::string_view t_contents) : contents(t_contents) {}
+
+  template <typename T>
+  T Read() {
+    T value;
+    std::memcpy(&value, Take(sizeof(T)).data(), sizeof(T));
+    return value;
+  }
+
+  std::string_view ReadString() {
+    return Take(static_cast<std::size_t>(Read<std::uint64_t>()));
+  }
+
+  bool empty() const { return contents.empty(); }
+
+  std::string_view Take(const std::size_t &size) {
+    if (size > contents.size()) throw std::runtime_error("truncated image");
+    const std::string_view value = contents.substr(0, size);
+    contents.remove_prefix(size);
+    return value;
+  }
+
+ private:
+  std::string_view contents;
+};
+
+inline void WriteDateTime(const string_operations::DateTimeFields &fields,
+                          std::string *out) {
+  WriteTag(ImageTag::DATETIME, out);
+  WriteRaw(static_cast<std::uint8_t>(fields.kind), out);
+  WriteRaw(static_cast<std::int16_t>(fields.year), out);
+  for (const int &field : {fields.month, fields.day, fields.hour,
+                           fields.minute, fields.second}) {
+    WriteRaw(static_cast<std::uint8_t>(field), out);
+  }
+  WriteRaw(static_cast<std::int32_t>(fields.microsecond), out);
+  WriteRaw(static_cast<std::uint8_t>(fields.has_offset), out);
+  WriteRaw(static_cast<std::int16_t>(fields.offset), out);
+}
+
+inline py::object ReadDateTime(ImageReader *reader) {
+  string_operations::DateTimeFields fields;
+  fields.kind = static_cast<string_operations::DateTimeKind>(
+      reader->Read<std::uint8_t>());
+  fields.year = reader->Read<std::int16_t>();
+  for (int *field : {&fields.month, &fields.day, &fields.hour, &fields.minute,
+                     &fields.second}) {
+    *field = reader->Read<std::uint8_t>();
+  }
+  fields.microsecond = reader->Read<std::int32_t>();
+  fields.has_offset = reader->Read<std::uint8_t>();
+  fields.offset = reader->Read<std::int16_t>();
+  return string_operations::make_datetime(fields);
+}
+
+// types encoded as str(value), rebuilt by calling the type
+inline const py::object *TextType(const ImageTag &tag) {
+  const auto &types = string_operations::py_types();
+  switch (tag) {
+    case ImageTag::DECIMAL:
+      return &types.decimal;
+    case ImageTag::UUID:
+      return &types.uuid;
+    case ImageTag::IPV4:
+      return &types.ipv4_address;
+    case ImageTag::IPV6:
+      return &types.ipv6_address;
+    default:
+      return nullptr;
+  }
+}
+
+inline bool EncodeText(PyObject *ptr, std::string *out) {
+  for (const ImageTag &tag :
+       {ImageTag::DECIMAL, ImageTag::UUID, ImageTag::IPV4, ImageTag::IPV6}) {
+    const auto *type = reinterpret_cast<PyTypeObject *>(TextType(tag)->ptr());
+    if (Py_TYPE(ptr) != type) continue;
+    const std::string text = py::str(py::handle(ptr));
+    WriteTag(tag, out);
+    WriteString(text, out);
+    return true;
+  }
+  return false;
+}
+
+// scalars with a native encoding (false -> no encoding)
+inline bool EncodeScalar(const py::handle &value, std::string *out) {
+  PyObject *ptr = value.ptr();
+  if (ptr == Py_None) {
+    WriteTag(ImageTag::NONE, out);
+  } else if (PyBool_Check(ptr)) {
+    WriteTag(ptr == Py_True ? ImageTag::TRUE : ImageTag::FALSE, out);
+  } else if (PyUnicode_CheckExact(ptr)) {
+    Py_ssize_t size = 0;
+    const char *data = PyUnicode_AsUTF8AndSize(ptr, &size);
+    if (!data) throw py::error_already_set();
+    WriteTag(ImageTag::STR, out);
+    WriteString(std::string_view(data, static_cast<std::size_t>(size)), out);
+  } else if (PyFloat_CheckExact(ptr)) {
+    WriteTag(ImageTag::FLOAT, out);
+    WriteRaw(PyFloat_AS_DOUBLE(ptr), out);
+  } else if (PyLong_CheckExact(ptr)) {
+    int overflow = 0;
+    const std::int64_t integer = PyLong_AsLongLongAndOverflow(ptr, &overflow);
+    if (overflow) {
+      const auto size =
+          (value.attr("bit_length")().cast<std::size_t>() + 8) / 8;
+      const std::string bytes = py::bytes(
+          value.attr("to_bytes")(size, "little", py::arg("signed") = true));
+      WriteTag(ImageTag::BIG_INT, out);
+      WriteString(bytes, out);
+    } else {
+      WriteTag(ImageTag::INT, out);
+      WriteRaw(integer, out);
+    }
+  } else {
+    string_operations::DateTimeFields fields;
+    if (string_operations::datetime_fields(value, &fields)) {
+      WriteDateTime(fields, out);
+      return true;
+    }
+    return EncodeText(ptr, out);
+  }
+  return true;
+}
+
+/// Encode a value tree (nested lists / dicts of natively encoded scalars)
+///
+/// @param value python object
+/// @param out image contents
+/// @param depth nesting of value
+/// @throws std::runtime_error for values without an encoding (the image is
+/// not written then)
+void EncodeValue(const py::handle &value, std::string *out,
+                 const std::size_t &depth = 0) {
+  if (EncodeScalar(value, out)) return;
+  if (depth >= IMAGE_MAX_DEPTH) {
+    throw std::runtime_error("value nested too deep");
+  }
+
+  if (PyList_CheckExact(value.ptr())) {
+    const auto list = py::reinterpret_borrow<py::list>(value);
+    WriteTag(ImageTag::LIST, out);
+    WriteRaw(static_cast<std::uint64_t>(py::len(list)), out);
+    for (const auto &item : list) EncodeValue(item, out, depth + 1);
+  } else if (PyDict_CheckExact(value.ptr())) {
+    const auto dict = py::reinterpret_borrow<py::dict>(value);
+    WriteTag(ImageTag::DICT, out);
+    WriteRaw(static_cast<std::uint64_t>(py::len(dict)), out);
+    for (const auto &item : dict) {
+      EncodeValue(item.first, out, depth + 1);
+      EncodeValue(item.second, out, depth + 1);
+    }
+  } else {
+    throw std::runtime_error(std::string("no encoding for values of type ") +
+                             Py_TYPE(value.ptr())->tp_name);
+  }
+}
+
+py::object DecodeValue(ImageReader *reader, const std::size_t &depth = 0) {
+  const auto tag = static_cast<ImageTag>(reader->Read<std::uint8_t>());
+  switch (tag) {
+    case ImageTag::NONE:
+      return py::none();
+    case ImageTag::TRUE:
+      return py::bool_(true);
+    case ImageTag::FALSE:
+      return py::bool_(false);
+    case ImageTag::INT:
+      return py::int_(reader->Read<std::int64_t>());
+    case ImageTag::FLOAT:
+      return py::float_(reader->Read<double>());
+    case ImageTag::STR: {
+      const std::string_view value = reader->ReadString();
+      return py::str(value.data(), value.size());
+    }
+    case ImageTag::LIST:
+    case ImageTag::DICT: {
+      if (depth >= IMAGE_MAX_DEPTH) {
+        throw std::runtime_error("image nested too deep");
+      }
+      const auto size = reader->Read<std::uint64_t>();
+      if (tag == ImageTag::LIST) {
+        py::list result;
+        for (std::uint64_t idx = 0; idx < size; ++idx) {
+          result.append(DecodeValue(reader, depth + 1));
+        }
+        return std::move(result);
+      }
+      py::dict result;
+      for (std::uint64_t idx = 0; idx < size; ++idx) {
+        const py::object key = DecodeValue(reader, depth + 1);
+        result[key] = DecodeValue(reader, depth + 1);
+      }
+      return std::move(result);
+    }
+    case ImageTag::BIG_INT: {
+      const std::string_view value = reader->ReadString();
+      return string_operations::py_types().int_type.attr("from_bytes")(
+          py::bytes(value.data(), value.size()), "little",
+          py::arg("signed") = true);
+    }
+    case ImageTag::DATETIME:
+      return ReadDateTime(reader);
+    case ImageTag::DECIMAL:
+    case ImageTag::UUID:
+    case ImageTag::IPV4:
+    case ImageTag::IPV6: {
+      const std::string_view value = reader->ReadString();
+      return (*TextType(tag))(py::str(value.data(), value.size()));
+    }
+    default:
+      throw std::runtime_error("invalid image tag");
+  }
+}
+
+// source unchanged since the image was written (the contents are only
+// hashed if the stat changed or was racy when they were read)
+inline bool IsCurrent(const ImageSource &source) {
+  switch (source.type) {
+    case ImageSourceType::MISSING:
+      return !system_operations::file_exists(source.path);
+    case ImageSourceType::CONTENTS: {
+      system_operations::FileStat stat;
+      if (!system_operations::file_stat(source.path, &stat) ||
+          !stat.is_regular) {
+        return false;
+      }
+      if (stat == source.stat && !IsRacy(stat, source.read_ns)) return true;
+      return ContentHash(system_operations::map_file(source.path)->view()) ==
+             source.hash;
+    }
+    case ImageSourceType::LISTING:
+      return ListingHash(system_operations::expand_path(source.path)) ==
+             source.hash;
+    default:
+      return false;
+  }
+}
+
+/// Content hash of source files (64-bit FNV-1a, stable across processes)
+///
+/// @param contents file contents
+/// @returns hash
+std::uint64_t ContentHash(const std::string_view &contents) {
+  std::uint64_t hash = 14695981039346656037ULL;
+  for (const char &value : contents) {
+    hash ^= static_cast<unsigned char>(value);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+/// Hash of the files matching a directory / glob pattern
+///
+/// @param paths matching files (sorted)
+/// @returns hash
+std::uint64_t ListingHash(const std::vector<std::string> &paths) {
+  std::string listing;
+  for (const auto &path : paths) {
+    listing += path;
+    listing += '\0';
+  }
+  return ContentHash(listing);
+}
+
+/// Load a typed ini_load result from a binary image
+///
+/// @param image path of the image
+/// @param key arguments the result has to be loaded with
+/// @param result environment to fill
+/// @returns false if the image is missing, stale or invalid
+bool ReadImage(const std::string &image, const std::string &key,
+               py::dict *result) {
+  if (!system_operations::file_exists(image)) return false;
+  try {
+    const auto contents = system_operations::map_file(image);
+    ImageReader reader(contents->view());
+    if (reader.Take(sizeof(IMAGE_MAGIC)) !=
+            std::string_view(IMAGE_MAGIC, sizeof(IMAGE_MAGIC)) ||
+        reader.Read<std::uint32_t>() != IMAGE_VERSION ||
+        reader.Read<std::uint32_t>() != IMAGE_BYTE_ORDER ||
+        reader.ReadString() != key) {
+      return false;
+    }
+
+    const auto sources = reader.Read<std::uint64_t>();
+    for (std::uint64_t idx = 0; idx < sources; ++idx) {
+      ImageSource source;
+      source.path = std::string(reader.ReadString());
+      source.type = static_cast<ImageSourceType>(reader.Read<std::uint8_t>());
+      source.hash = reader.Read<std::uint64_t>();
+      source.stat.path = source.path;
+      source.stat.mtime_ns = reader.Read<std::int64_t>();
+      source.stat.size = reader.Read<std::uint64_t>();
+      source.stat.inode = reader.Read<std::uint64_t>();
+      source.stat.device = reader.Read<std::uint64_t>();
+      source.read_ns = reader.Read<std::int64_t>();
+      if (!IsCurrent(source)) return false;
+    }
+
+    const py::object value = DecodeValue(&reader);
+    if (!PyDict_CheckExact(value.ptr()) || !reader.empty()) return false;
+    *result = py::reinterpret_borrow<py::dict>(value);
+    return true;
+  } catch (const std::exception &error) {
+    py::module::import("logging")
+        .attr("debug")("invalid ini image '" + image + "': " + error.what());
+    return false;
+  }
+}
+
+/// Write a typed ini_load result as binary image (replaced atomically,
+/// failures and values without an encoding are logged and skip the image)
+///
+/// @param image path of the image
+/// @param key arguments the result was loaded with
+/// @param sources source files with the hashes of the parsed contents
+/// @param result environment to store
+void WriteImage(const std::string &image, const std::string &key,
+                const std::vector<ImageSource> &sources,
+                const py::dict &result) {
+  const std::string temp_image =
+      image + ".tmp" + std::to_string(std::random_device()());
+  try {
+    std::string out(IMAGE_MAGIC, sizeof(IMAGE_MAGIC));
+    WriteRaw(IMAGE_VERSION, &out);
+    WriteRaw(IMAGE_BYTE_ORDER, &out);
+    WriteString(key, &out);
+    WriteRaw(static_cast<std::uint64_t>(sources.size()), &out);
+    for (const auto &source : sources) {
+      WriteString(source.path, &out);
+      WriteRaw(static_cast<std::uint8_t>(source.type), &out);
+      WriteRaw(source.hash, &out);
+      WriteRaw(source.stat.mtime_ns, &out);
+      WriteRaw(source.stat.size, &out);
+      WriteRaw(source.stat.inode, &out);
+      WriteRaw(source.stat.device, &out);
+      WriteRaw(source.read_ns, &out);
+    }
+    EncodeValue(result, &out);
+
+    {
+      std::ofstream file(temp_image, std::ios::out | std::ios::binary);
+      file.write(out.data(), static_cast<std::streamsize>(out.size()));
+      if (!file.good()) throw std::runtime_error("failed to write");
+    }
+#ifdef _WIN32
+    std::remove(image.c_str());
+#endif
+    if (std::rename(temp_image.c_str(), image.c_str())) {
+      throw std::runtime_error("failed to replace the image");
+    }
+  } catch (const std::exception &error) {
+    std::remove(temp_image.c_str());
+    py::module::import("logging")
+        .attr("debug")("skipping ini image '" + image + "': " + error.what());
+  }
+}
+
+}  // namespace ini
@@ -0,0 +1,49 @@
+// Copyright (c) 2022 Semjon Geist.
+#ifndef INST__CORNFLAKES_INI_IMAGE_HPP_
+#define INST__CORNFLAKES_INI_IMAGE_HPP_
+
+// clang-format off
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <string_operations.hpp>
+#include <system_operations.hpp>
+// clang-format on
+
+namespace ini {  // cppcheck-suppress syntaxError
+// Binary image of a typed ini_load result (native byte order):
+//   magic, version, byte order mark
+//   key (files / selection / defaults the result was loaded with)
+//   sources (path, type, hash of the contents / listing, stat and read time
+//   of the contents)
+//   value tree (tag + payload, results with other types are not written)
+inline const char IMAGE_MAGIC[8] = {'C', 'F', 'L', 'K', 'I', 'M', 'G', '\0'};
+inline const std::uint32_t IMAGE_VERSION = 3;
+inline const std::uint32_t IMAGE_BYTE_ORDER = 0x01020304;
+
+enum class ImageSourceType : std::uint8_t {
+  MISSING,   // file did not exist
+  CONTENTS,  // parsed file
+  LISTING,   // directory / glob pattern (matching files)
+};
+
+// source of an image (missing files are recorded too)
+struct ImageSource {
+  std::string path;
+  ImageSourceType type;
+  std::uint64_t hash;  // ContentHash of the parsed contents / ListingHash
+  system_operations::FileStat stat;  // before the contents were read
+  std::int64_t read_ns = 0;          // wall clock before the read
+};
+
+std::uint64_t ContentHash(const std::string_view &contents);
+std::uint64_t ListingHash(const std::vector<std::string> &paths);
+bool ReadImage(const std::string &image, const std::string &key,
+               py::dict *result);
+void WriteImage(const std::string &image, const std::string &key,
+                const std::vector<ImageSource> &sources,
+                const py::dict &result);
+}  // namespace ini
+
+#endif  // INST__CORNFLAKES_INI_IMAGE_HPP_
@@ -0,0 +1,159 @@
+// Copyright (c) 2022 Semjon Geist.
+#include <ini_interpolation.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+//! Native ${...} interpolation of ini values (no python objects involved)
+namespace ini {
+
+/// Build the reference scopes of a file
+///
+/// @param t_index tokenized file
+/// @param t_environment environment for ${ENV} references
+/// @param t_strings owner of the substituted values (lives with the tree)
+Interpolator::Interpolator(const FileIndex &t_index,
+                           const system_operations::Environment &t_environment,
+                           std::deque<std::string> *t_strings)
+    : index(t_index), environment(t_environment), strings(t_strings) {
+  const std::string_view contents = index.contents->view();
+  const auto add_scope = [&](const std::string_view &name,
+                             const std::array<std::size_t, 2> &line_cursor) {
+    auto &keys = scopes[name];
+    const auto entry_cursor = EntryCursor(index, line_cursor);
+    for (std::size_t idx = entry_cursor[0]; idx < entry_cursor[1]; ++idx) {
+      keys[index.entries[idx].key] = index.entries[idx].value;
+    }
+  };
+
+  scope_begins.emplace(contents.data(), std::string_view());
+  add_scope({}, {0, index.sections.empty() ? index.lines.size()
+                                           : index.sections[0].line_cursor[0]});
+  for (const auto &section : index.sections) {
+    const std::size_t header_idx = section.line_cursor[0] - 1;
+    scope_begins[index.lines[header_idx].line.data()] = section.name;
+    add_scope(section.name, section.line_cursor);
+  }
+}
+
+// section of a value (view into the file contents)
+std::string_view Interpolator::ScopeOf(const std::string_view &value) const {
+  const auto joined = index.joined_origin.find(value.data());
+  auto iter = scope_begins.upper_bound(
+      joined == index.joined_origin.end() ? value.data() : joined->second);
+  return iter == scope_begins.begin() ? std::string_view() : (--iter)->second;
+}
+
+// raw value of a key (nullptr -> not defined)
+const std::string_view *Interpolator::RawValue(const Node &node) const {
+  const auto keys = scopes.find(node.first);
+  if (keys == scopes.end()) return nullptr;
+  const auto raw = keys->second.find(node.second);
+  return raw == keys->second.end() ? nullptr : &raw->second;
+}
+
+// resolved value of a referenced key / environment variable
+bool Interpolator::Reference(const std::string_view &scope,
+                             const std::string_view &name,
+                             std::string_view *value) {
+  const std::size_t section_idx = name.find(REFERENCE_SECTION);
+  Node node =
+      section_idx == std::string_view::npos
+          ? Node(scope, name)
+          : Node(name.substr(0, section_idx), name.substr(section_idx + 1));
+
+  const std::string_view *raw = RawValue(node);
+  if (raw == nullptr && section_idx == std::string_view::npos &&
+      !node.first.empty()) {
+    node = Node({}, name);  // keys before the first section
+    raw = RawValue(node);
+  }
+  if (raw == nullptr) {
+    if (section_idx != std::string_view::npos) return false;
+    std::string env_name(name);
+    std::transform(env_name.begin(), env_name.end(), env_name.begin(),
+                   ::toupper);
+    const std::string *env_value =
+        environment.find(std::string(name), env_name);
+    if (env_value == nullptr) return false;
+    *value = *env_value;
+    return true;
+  }
+
+  const auto done = resolved.find(node);
+  if (done != resolved.end()) {
+    *value = done->second;
+    return true;
+  }
+  if (std::find(path.begin(), path.end(), node) != path.end()) {
+    std::string cycle;
+    for (const auto &item : path) {
+      cycle += std::string(item.first) + REFERENCE_SECTION +
+               std::string(item.second) + " -> ";
+    }
+    throw std::runtime_error("interpolation cycle: " + cycle +
+                             std::string(node.first) + REFERENCE_SECTION +
+                             std::string(node.second));
+  }
+
+  path.push_back(node);
+  *value = Substitute(node.first, *raw);
+  path.pop_back();
+  resolved.emplace(node, *value);
+  return true;
+}
+
+// substitute all references of a value
+std::string_view Interpolator::Substitute(const std::string_view &scope,
+                                          const std::string_view &value) {
+  std::size_t open_idx = value.find(REFERENCE_OPEN);
+  if (open_idx == std::string_view::npos) return value;
+
+  std::string result;
+  std::size_t copy_idx = 0;
+  for (; open_idx != std::string_view::npos;
+       open_idx = value.find(REFERENCE_OPEN, open_idx + 1)) {
+    if (open_idx && value[open_idx - 1] == REFERENCE_OPEN[0]) {
+      // $${ -> ${
+      result.append(value.substr(copy_idx, open_idx - copy_idx - 1));
+      copy_idx = open_idx;
+      continue;
+    }
+    const std::size_t close_idx = value.find(REFERENCE_CLOSE, open_idx);
+    if (close_idx == std::string_view::npos) break;
+
+    std::string_view reference;
+    if (!Reference(scope,
+                   value.substr(open_idx + REFERENCE_OPEN.size(),
+                                close_idx - open_idx - REFERENCE_OPEN.size()),
+                   &reference)) {
+      continue;
+    }
+    result.append(value.substr(copy_idx, open_idx - copy_idx));
+    result.append(reference);
+    copy_idx = close_idx + 1;
+  }
+  if (!copy_idx) return value;
+  result.append(value.substr(copy_idx));
+  return strings->emplace_back(std::move(result));
+}
+
+/// Substitute the references of a value
+///
+/// @param value raw value (view into the file contents)
+/// @returns value itself (no references) or the substituted value
+std::string_view Interpolator::Resolve(const std::string_view &value) {
+  path.clear();  // left over by a cycle
+  return Substitute(ScopeOf(value), value);
+}
+
+/// File contains (possible) references
+///
+/// @param contents file contents
+/// @returns true if interpolation has to run
+bool HasReferences(const std::string_view &contents) {
+  return contents.find(REFERENCE_OPEN) != std::string_view::npos;
+}
+
+}  // namespace ini
@@ -0,0 +1,59 @@
+// Copyright (c) 2022 Semjon Geist.
+#ifndef INST__CORNFLAKES_INI_INTERPOLATION_HPP_
+#define INST__CORNFLAKES_INI_INTERPOLATION_HPP_
+
+// clang-format off
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <ini_tokenizer.hpp>
+#include <system_operations.hpp>
+// clang-format on
+
+namespace ini {  // cppcheck-suppress syntaxError
+inline const std::string_view REFERENCE_OPEN = "${";
+inline const char REFERENCE_CLOSE = '}';
+inline const char REFERENCE_SECTION = ':';
+
+// Substitutes ${section:key} and ${key} references of a file before its
+// values are typed (${key} -> same section, keys before the first section,
+// environment). Referenced keys are resolved depth first over the dependency
+// graph (cycles raise), unknown references are kept as they are and $${
+// escapes a reference.
+class Interpolator {
+ public:
+  Interpolator(const FileIndex &t_index,
+               const system_operations::Environment &t_environment,
+               std::deque<std::string> *t_strings);
+  std::string_view Resolve(const std::string_view &value);
+
+ private:
+  using Node = std::pair<std::string_view, std::string_view>;  // section, key
+  std::string_view Substitute(const std::string_view &scope,
+                              const std::string_view &value);
+  const std::string_view *RawValue(const Node &node) const;
+  bool Reference(const std::string_view &scope, const std::string_view &name,
+                 std::string_view *value);
+  std::string_view ScopeOf(const std::string_view &value) const;
+
+  const FileIndex &index;
+  const system_operations::Environment &environment;
+  std::deque<std::string> *strings;  // owner of substituted values
+  // section ("" before the first section) -> key -> last raw value
+  std::unordered_map<std::string_view,
+                     std::unordered_map<std::string_view, std::string_view>>
+      scopes;
+  std::map<const char *, std::string_view> scope_begins;  // offset -> scope
+  std::map<Node, std::string_view> resolved;
+  std::vector<Node> path;  // keys being resolved (cycle detection)
+};
+
+bool HasReferences(const std::string_view &contents);
+}  // namespace ini
+
+#endif  // INST__CORNFLAKES_INI_INTERPOLATION_HPP_
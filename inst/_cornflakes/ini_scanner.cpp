@@ -0,0 +1,194 @@
+// Copyright (c) 2022 Semjon Geist.
+#include <ini_scanner.hpp>
+#include <ini_tokenizer.hpp>
+
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <immintrin.h>
+#define INI_SCANNER_SSE2
+#if defined(__GNUC__) || defined(__clang__)
+#define INI_SCANNER_AVX2  // compiled with target("avx2"), picked at runtime
+#endif
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+//! Structural character scanner (SSE2 / AVX2 with scalar fallback)
+namespace ini {
+// bytes covered by a single bitmap word
+inline const std::size_t BLOCK_SIZE = 64;
+
+inline std::size_t TrailingZeros(std::uint64_t mask) {
+#ifdef _MSC_VER
+  unsigned long idx;  // NOLINT(runtime/int)
+  _BitScanForward64(&idx, mask);
+  return idx;
+#else
+  return __builtin_ctzll(mask);
+#endif
+}
+
+inline bool IsStructural(const char &value) {
+  return value == system_operations::NEWLINE || value == COMMENT_CHAR ||
+         value == NEWVALUE;
+}
+
+// scalar fallback (and the tail of the vectorized scanners)
+inline std::uint64_t ScanScalar(const char *data, std::size_t size) {
+  std::uint64_t mask = 0;
+  for (std::size_t idx = 0; idx < size; ++idx) {
+    mask |= static_cast<std::uint64_t>(IsStructural(data[idx])) << idx;
+  }
+  return mask;
+}
+
+using ScanBlock = std::uint64_t (*)(const char *data);
+
+std::uint64_t ScanBlockScalar(const char *data) {
+  return ScanScalar(data, BLOCK_SIZE);
+}
+
+#ifdef INI_SCANNER_SSE2
+std::uint64_t ScanBlockSSE2(const char *data) {
+  const __m128i newline = _mm_set1_epi8(system_operations::NEWLINE);
+  const __m128i comment = _mm_set1_epi8(COMMENT_CHAR);
+  const __m128i newvalue = _mm_set1_epi8(NEWVALUE);
+  std::uint64_t mask = 0;
+  for (std::size_t idx = 0; idx < BLOCK_SIZE; idx += 16) {
+    const __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + idx));
+    const __m128i matches =
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, newline),
+                                  _mm_cmpeq_epi8(chunk, comment)),
+                     _mm_cmpeq_epi8(chunk, newvalue));
+    mask |= static_cast<std::uint64_t>(
+                static_cast<std::uint16_t>(_mm_movemask_epi8(matches)))
+            << idx;
+  }
+  return mask;
+}
+#endif
+
+#ifdef INI_SCANNER_AVX2
+__attribute__((target("avx2"))) std::uint64_t ScanBlockAVX2(
+    const char *data) {
+  const __m256i newline = _mm256_set1_epi8(system_operations::NEWLINE);
+  const __m256i comment = _mm256_set1_epi8(COMMENT_CHAR);
+  const __m256i newvalue = _mm256_set1_epi8(NEWVALUE);
+  std::uint64_t mask = 0;
+  for (std::size_t idx = 0; idx < BLOCK_SIZE; idx += 32) {
+    const __m256i chunk =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + idx));
+    const __m256i matches =
+        _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, newline),
+                                        _mm256_cmpeq_epi8(chunk, comment)),
+                        _mm256_cmpeq_epi8(chunk, newvalue));
+    mask |= static_cast<std::uint64_t>(
+                static_cast<std::uint32_t>(_mm256_movemask_epi8(matches)))
+            << idx;
+  }
+  return mask;
+}
+#endif
+
+// widest scanner supported by the cpu (selected once)
+inline ScanBlock SelectScanner() {
+#ifdef INI_SCANNER_AVX2
+  if (__builtin_cpu_supports("avx2")) return ScanBlockAVX2;
+#endif
+#ifdef INI_SCANNER_SSE2
+  return ScanBlockSSE2;
+#else
+  return ScanBlockScalar;
+#endif
+}
+
+inline ScanBlock Scanner() {
+  static const ScanBlock scanner = SelectScanner();
+  return scanner;
+}
+
+// scanner of a type (invalid_argument if not supported by the build / cpu)
+inline ScanBlock Scanner(const ScannerType &type) {
+  switch (type) {
+    case ScannerType::AUTO:
+      return Scanner();
+    case ScannerType::SCALAR:
+      return ScanBlockScalar;
+#ifdef INI_SCANNER_SSE2
+    case ScannerType::SSE2:
+      return ScanBlockSSE2;
+#endif
+#ifdef INI_SCANNER_AVX2
+    case ScannerType::AVX2:
+      if (__builtin_cpu_supports("avx2")) return ScanBlockAVX2;
+      break;
+#endif
+    default:
+      break;
+  }
+  throw std::invalid_argument("scanner not supported on this platform");
+}
+
+/// Build the structural bitmap of ini contents
+///
+/// @param contents ini file contents
+/// @param type block scanner (AUTO -> widest supported one)
+StructuralIndex::StructuralIndex(const std::string_view &contents,
+                                 const ScannerType &type) {
+  const std::size_t blocks = contents.size() / BLOCK_SIZE;
+  const ScanBlock scan = Scanner(type);
+  bits.resize(blocks + 1);
+  for (std::size_t idx = 0; idx < blocks; ++idx) {
+    bits[idx] = scan(contents.data() + idx * BLOCK_SIZE);
+  }
+  bits[blocks] = ScanScalar(contents.data() + blocks * BLOCK_SIZE,
+                            contents.size() - blocks * BLOCK_SIZE);
+}
+
+/// Position of the next structural character
+///
+/// @param pos first position to check
+/// @returns position (npos if there is none left)
+std::size_t StructuralIndex::Next(std::size_t pos) const {
+  std::size_t word = pos / BLOCK_SIZE;
+  if (word >= bits.size()) return std::string_view::npos;
+  std::uint64_t mask = bits[word] & (~std::uint64_t(0) << (pos % BLOCK_SIZE));
+  while (!mask) {
+    if (++word == bits.size()) return std::string_view::npos;
+    mask = bits[word];
+  }
+  return word * BLOCK_SIZE + TrailingZeros(mask);
+}
+
+/// Scanner type by name
+///
+/// @param name auto, scalar, sse2 or avx2
+/// @returns scanner type (invalid_argument for unknown names)
+ScannerType ParseScannerType(const std::string &name) {
+  if (name == "auto") return ScannerType::AUTO;
+  if (name == "scalar") return ScannerType::SCALAR;
+  if (name == "sse2") return ScannerType::SSE2;
+  if (name == "avx2") return ScannerType::AVX2;
+  throw std::invalid_argument("unknown scanner '" + name + "'");
+}
+
+/// Positions of all structural characters (compares the block scanners)
+///
+/// @param contents ini file contents
+/// @param type block scanner
+/// @returns positions in ascending order
+std::vector<std::size_t> StructuralPositions(const std::string_view &contents,
+                                             const ScannerType &type) {
+  const StructuralIndex index(contents, type);
+  std::vector<std::size_t> result;
+  for (std::size_t pos = index.Next(0); pos != std::string_view::npos;
+       pos = index.Next(pos + 1)) {
+    result.push_back(pos);
+  }
+  return result;
+}
+
+}  // namespace ini
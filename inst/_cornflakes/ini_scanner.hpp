@@ -0,0 +1,40 @@
+// Copyright (c) 2022 Semjon Geist.
+#ifndef INST__CORNFLAKES_INI_SCANNER_HPP_
+#define INST__CORNFLAKES_INI_SCANNER_HPP_
+
+// clang-format off
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+// clang-format on
+
+namespace ini {  // cppcheck-suppress syntaxError
+// Block scanner of a StructuralIndex (AUTO -> widest one supported by the
+// cpu, the others are selected explicitly to compare them)
+enum class ScannerType : std::uint8_t {
+  AUTO,
+  SCALAR,
+  SSE2,
+  AVX2,
+};
+
+// Bitmap of the structural characters (NEWLINE, COMMENT_CHAR, NEWVALUE) of
+// ini contents, built in one (vectorized) pass over all bytes
+class StructuralIndex {
+ public:
+  explicit StructuralIndex(const std::string_view &contents,
+                           const ScannerType &type = ScannerType::AUTO);
+  std::size_t Next(std::size_t pos) const;
+
+ private:
+  std::vector<std::uint64_t> bits;  // bit i -> byte i is structural
+};
+
+ScannerType ParseScannerType(const std::string &name);
+std::vector<std::size_t> StructuralPositions(const std::string_view &contents,
+                                             const ScannerType &type);
+}  // namespace ini
+
+#endif  // INST__CORNFLAKES_INI_SCANNER_HPP_
@@ -0,0 +1,157 @@
+// Copyright (c) 2022 Semjon Geist.
+#include <ini_schema.hpp>
+
+#include <stdexcept>
+#include <utility>
+
+//! Schema directed typing of ini values (known target types)
+namespace ini {
+inline const char *const SCHEMA_TYPE_NAMES[] = {
+    "any",      "str",  "int",  "float", "bool",        "Decimal",
+    "datetime", "date", "time", "UUID",  "IPv4Address", "IPv6Address"};
+
+// typing.Union or types.UnionType (PEP 604 unions, python >= 3.10)
+inline bool IsUnion(const py::handle &origin) {
+  if (origin.is(py::module::import("typing").attr("Union"))) return true;
+  py::object types = py::module::import("types");
+  return py::hasattr(types, "UnionType") && origin.is(types.attr("UnionType"));
+}
+
+// Optional[T] / Union[T, None] / T | None -> T (other generics are not typed)
+inline py::object UnwrapOptional(const py::handle &type) {
+  py::object typing = py::module::import("typing");
+  if (!IsUnion(typing.attr("get_origin")(type))) {
+    return py::reinterpret_borrow<py::object>(type);
+  }
+  py::object result = py::none();
+  for (const auto &arg : typing.attr("get_args")(type)) {
+    if (arg.is(py::module::import("builtins").attr("type")(py::none()))) {
+      continue;
+    }
+    if (!result.is_none()) return py::none();
+    result = py::reinterpret_borrow<py::object>(arg);
+  }
+  return result;
+}
+
+inline SchemaType TypeOf(const py::handle &type) {
+  const py::object target = UnwrapOptional(type);
+  if (target.is_none()) return SchemaType::ANY;
+
+  py::object builtins = py::module::import("builtins");
+  py::object datetime = py::module::import("datetime");
+  py::object ipaddress = py::module::import("ipaddress");
+  const std::pair<py::object, SchemaType> types[] = {
+      {builtins.attr("str"), SchemaType::STR},
+      {builtins.attr("int"), SchemaType::INT},
+      {builtins.attr("float"), SchemaType::FLOAT},
+      {builtins.attr("bool"), SchemaType::BOOL},
+      {py::module::import("decimal").attr("Decimal"), SchemaType::DECIMAL},
+      {datetime.attr("datetime"), SchemaType::DATETIME},
+      {datetime.attr("date"), SchemaType::DATE},
+      {datetime.attr("time"), SchemaType::TIME},
+      {py::module::import("uuid").attr("UUID"), SchemaType::UUID},
+      {ipaddress.attr("IPv4Address"), SchemaType::IPV4},
+      {ipaddress.attr("IPv6Address"), SchemaType::IPV6},
+  };
+  for (const auto &item : types) {
+    if (target.is(item.first)) return item.second;
+  }
+  return SchemaType::ANY;
+}
+
+/// Compile a schema (needs the GIL)
+///
+/// @param schema mapping of key to target type (str, int, float, bool,
+/// Decimal, datetime, date, time, UUID, IPv4Address, IPv6Address or
+/// Optional of them), other types are inferred with eval_type
+Schema::Schema(const py::object &schema) {
+  if (schema.is_none()) return;
+  for (const auto &item : schema.attr("items")()) {
+    const py::tuple pair = py::reinterpret_borrow<py::tuple>(item);
+    const SchemaType type = TypeOf(pair[1]);
+    if (type != SchemaType::ANY) {
+      m_types.emplace(py::str(pair[0]).cast<std::string>(), type);
+    }
+  }
+}
+
+/// Target type of a key
+///
+/// @param key key name (result key)
+/// @returns type of the key (ANY if not typed)
+SchemaType Schema::find(const std::string_view &key) const {
+  const auto type_iter = m_types.find(key);
+  return type_iter == m_types.end() ? SchemaType::ANY : type_iter->second;
+}
+
+std::string Schema::key() const {
+  std::string result;
+  for (const auto &item : m_types) {
+    result += std::to_string(item.first.size()) + ':' + item.first +
+              std::to_string(static_cast<int>(item.second));
+  }
+  return result;
+}
+
+const char *SchemaTypeName(const SchemaType &type) {
+  return SCHEMA_TYPE_NAMES[static_cast<std::size_t>(type)];
+}
+
+// date / time types: the datetime formats of eval_type first (so a typed
+// value equals the inferred one, same timezone handling), ISO 8601 otherwise;
+// only the exact target type is accepted (a datetime is no date value)
+inline py::object EvalDatetime(const py::str &value, const py::object &target,
+                               const char *name) {
+  const auto is_target = [&target](const py::object &result) {
+    return Py_TYPE(result.ptr()) ==
+           reinterpret_cast<PyTypeObject *>(target.ptr());
+  };
+  py::object result =
+      string_operations::eval_datetime(value.cast<std::string>());
+  if (is_target(result)) return result;
+  try {
+    result = target.attr("fromisoformat")(value);
+    if (is_target(result)) return result;
+  } catch (py::error_already_set &) {
+  }
+  throw std::invalid_argument("invalid " + std::string(name) + " value '" +
+                              value.cast<std::string>() + "'");
+}
+
+/// Convert a value into a python type without the inference of eval_type
+/// (needs the GIL)
+///
+/// @param value unquoted raw value
+/// @param type target type
+/// @returns python object of the target type (raises ValueError)
+py::object EvalTyped(const std::string_view &value, const SchemaType &type) {
+  const py::str string(value.data(), value.size());
+  const auto &types = string_operations::py_types();
+  switch (type) {
+    case SchemaType::INT:
+      return types.int_type(string);
+    case SchemaType::FLOAT:
+      return types.float_type(string);
+    case SchemaType::DECIMAL:
+      return types.decimal(string);
+    case SchemaType::DATETIME:
+      return EvalDatetime(string, types.datetime, "datetime");
+    case SchemaType::DATE:
+      return EvalDatetime(string, types.date, "date");
+    case SchemaType::TIME:
+      return EvalDatetime(string, types.time, "time");
+    case SchemaType::UUID:
+      return types.uuid(string);
+    case SchemaType::IPV4:
+      return types.ipv4_address(string);
+    case SchemaType::IPV6:
+      return types.ipv6_address(string);
+    case SchemaType::STR:
+      return std::move(string);
+    default:
+      return string_operations::eval_type(std::string(value));
+  }
+}
+
+}  // namespace ini
@@ -0,0 +1,51 @@
+// Copyright (c) 2022 Semjon Geist.
+#ifndef INST__CORNFLAKES_INI_SCHEMA_HPP_
+#define INST__CORNFLAKES_INI_SCHEMA_HPP_
+
+// clang-format off
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <py_types.hpp>
+#include <string_operations.hpp>
+// clang-format on
+
+namespace ini {  // cppcheck-suppress syntaxError
+// Target type of a key (ANY -> eval_type inference)
+enum class SchemaType : std::uint8_t {
+  ANY,
+  STR,
+  INT,
+  FLOAT,
+  BOOL,
+  DECIMAL,
+  DATETIME,
+  DATE,
+  TIME,
+  UUID,
+  IPV4,
+  IPV6,
+};
+
+// Compiled key -> type mapping of ini_load (types of config dataclasses),
+// values of typed keys skip the eval_type inference and are converted by
+// the matching converter only (invalid values raise ValueError)
+class Schema {
+ public:
+  Schema() = default;
+  explicit Schema(const py::object &schema);
+  SchemaType find(const std::string_view &key) const;
+  bool empty() const { return m_types.empty(); }
+  std::string key() const;  // part of the image key
+
+ private:
+  std::map<std::string, SchemaType, std::less<>> m_types;
+};
+
+const char *SchemaTypeName(const SchemaType &type);
+py::object EvalTyped(const std::string_view &value, const SchemaType &type);
+}  // namespace ini
+
+#endif  // INST__CORNFLAKES_INI_SCHEMA_HPP_
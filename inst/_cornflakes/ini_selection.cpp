@@ -0,0 +1,74 @@
+// Copyright (c) 2022 Semjon Geist.
+#include <ini_selection.hpp>
+
+#include <algorithm>
+#include <cctype>
+
+//! Compiled sections / keys filters of ini_load
+namespace ini {
+
+inline std::vector<SectionSelection> CompileSections(
+    const std::map<std::string, std::vector<std::string>> &sections) {
+  std::vector<SectionSelection> result;
+  result.reserve(sections.size());
+  for (const auto &item : sections) {
+    SectionSelection section{item.first, string_operations::is_nan(item.first),
+                             {}};
+    for (const auto &item_value : item.second) {
+      section.sections.push_back(
+          {item_value, string_operations::is_nan(item_value)});
+    }
+    result.push_back(std::move(section));
+  }
+  return result;
+}
+
+inline std::vector<KeySelection> CompileKeys(
+    const std::map<std::string, std::vector<std::string>> &keys) {
+  std::vector<KeySelection> result;
+  result.reserve(keys.size());
+  for (const auto &item : keys) {
+    KeySelection key{item.first, {}};
+    for (const auto &item_value : item.second) {
+      KeyAlias alias{item_value, "", 0};  // default, 1=list, 2=dict
+      if (item_value == "*") alias.type = 1;
+      if (item_value == "**") alias.type = 2;
+      if (alias.type) alias.name = item.first;
+      alias.env_name = alias.name;
+      std::transform(alias.env_name.begin(), alias.env_name.end(),
+                     alias.env_name.begin(), ::toupper);
+      key.aliases.push_back(std::move(alias));
+    }
+    result.push_back(std::move(key));
+  }
+  return result;
+}
+
+Selection::Selection(
+    const std::map<std::string, std::vector<std::string>> &t_sections,
+    const std::map<std::string, std::vector<std::string>> &t_keys)
+    : m_sections(std::make_shared<const std::vector<SectionSelection>>(
+          CompileSections(t_sections))),
+      m_keys(std::make_shared<const std::vector<KeySelection>>(
+          CompileKeys(t_keys))) {}
+
+/// Compile sections / keys in the same formats as ini_load accepts them
+///
+/// @param t_sections sections (str, list or dict)
+/// @param t_keys keys (str, list or dict)
+Selection::Selection(const py::object &t_sections, const py::object &t_keys)
+    : Selection(string_operations::convert_to_map_str(t_sections),
+                string_operations::convert_to_map_str(t_keys)) {}
+
+/// Combine two selections, sections / keys missing here are taken from other
+///
+/// @param other selection with the fallback sections / keys
+/// @returns combined selection (shares the compiled parts)
+Selection Selection::WithDefaults(const Selection &other) const {
+  Selection result = *this;
+  if (m_sections->empty()) result.m_sections = other.m_sections;
+  if (m_keys->empty()) result.m_keys = other.m_keys;
+  return result;
+}
+
+}  // namespace ini
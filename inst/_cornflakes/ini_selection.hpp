@@ -0,0 +1,58 @@
+// Copyright (c) 2022 Semjon Geist.
+#ifndef INST__CORNFLAKES_INI_SELECTION_HPP_
+#define INST__CORNFLAKES_INI_SELECTION_HPP_
+
+// clang-format off
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <string_operations.hpp>
+// clang-format on
+
+namespace ini {  // cppcheck-suppress syntaxError
+// single name of a selected key (1=list "*", 2=dict "**")
+struct KeyAlias {
+  std::string name;      // key name in the file (wildcards -> key name)
+  std::string env_name;  // upper case name for the environment
+  int type;              // default, 1=list, 2=dict
+};
+
+struct KeySelection {
+  std::string name;  // key name in the result
+  std::vector<KeyAlias> aliases;
+};
+
+struct SectionName {
+  std::string name;
+  bool is_nan;  // no section / file without sections
+};
+
+struct SectionSelection {
+  std::string name;  // section name in the result
+  bool is_nan;       // keys go into the file environment
+  std::vector<SectionName> sections;
+};
+
+// Compiled sections / keys filter of ini_load, immutable and reusable
+// between calls (an empty selection loads all sections / keys)
+class Selection {
+ public:
+  Selection() = default;
+  Selection(const std::map<std::string, std::vector<std::string>> &t_sections,
+            const std::map<std::string, std::vector<std::string>> &t_keys);
+  Selection(const py::object &t_sections, const py::object &t_keys);
+  Selection WithDefaults(const Selection &other) const;
+  const std::vector<SectionSelection> &sections() const { return *m_sections; }
+  const std::vector<KeySelection> &keys() const { return *m_keys; }
+
+ private:
+  // shared -> combining selections does not copy them
+  std::shared_ptr<const std::vector<SectionSelection>> m_sections =
+      std::make_shared<const std::vector<SectionSelection>>();
+  std::shared_ptr<const std::vector<KeySelection>> m_keys =
+      std::make_shared<const std::vector<KeySelection>>();
+};
+}  // namespace ini
+
+#endif  // INST__CORNFLAKES_INI_SELECTION_HPP_
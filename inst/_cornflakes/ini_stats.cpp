@@ -0,0 +1,44 @@
+// Copyright (c) 2022 Semjon Geist.
+#include <ini_stats.hpp>
+
+//! Opt-in timings and counters of ini_load
+namespace ini {
+void LoadStats::Merge(const LoadStats &other) {
+  for (std::size_t idx = 0; idx < nanoseconds.size(); ++idx) {
+    nanoseconds[idx] += other.nanoseconds[idx];
+  }
+  files += other.files;
+  bytes += other.bytes;
+  cache_hits += other.cache_hits;
+  sections += other.sections;
+  keys += other.keys;
+  eval_type += other.eval_type;
+  for (const auto &item : other.types) types[item.first] += item.second;
+}
+
+/// Statistics of a single ini_load
+///
+/// @returns dict with the nanoseconds per phase (read, tokenize, parse,
+/// materialize, eval_type, image), files, bytes, cache_hits, sections, keys,
+/// eval_type calls and the number of typed values per type
+py::dict LoadStats::ToDict() const {
+  py::dict phases;
+  for (std::size_t idx = 0; idx < nanoseconds.size(); ++idx) {
+    phases[LOAD_PHASES[idx]] = nanoseconds[idx];
+  }
+  py::dict type_counts;
+  for (const auto &item : types) type_counts[py::str(item.first)] = item.second;
+
+  py::dict result;
+  result["nanoseconds"] = phases;
+  result["files"] = files;
+  result["bytes"] = bytes;
+  result["cache_hits"] = cache_hits;
+  result["sections"] = sections;
+  result["keys"] = keys;
+  result["eval_type"] = eval_type;
+  result["types"] = type_counts;
+  return result;
+}
+
+}  // namespace ini
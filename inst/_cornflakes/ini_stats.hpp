@@ -0,0 +1,77 @@
+// Copyright (c) 2022 Semjon Geist.
+#ifndef INST__CORNFLAKES_INI_STATS_HPP_
+#define INST__CORNFLAKES_INI_STATS_HPP_
+
+// clang-format off
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_operations.hpp>
+// clang-format on
+
+namespace ini {  // cppcheck-suppress syntaxError
+enum class LoadPhase : std::size_t {
+  READ,         // map / read the files
+  TOKENIZE,     // line / section / key index
+  PARSE,        // key extraction + native typing (without GIL)
+  MATERIALIZE,  // python objects + dict insertion
+  EVAL_TYPE,    // eval_type of deferred values
+  IMAGE,        // read / write the binary image
+  COUNT,
+};
+
+inline const char *const LOAD_PHASES[] = {
+    "read", "tokenize", "parse", "materialize", "eval_type", "image"};
+
+// Timings (summed over all threads) and counters of a single ini_load,
+// only collected if requested (nullptr -> no overhead besides the checks)
+struct LoadStats {
+  std::array<std::uint64_t, static_cast<std::size_t>(LoadPhase::COUNT)>
+      nanoseconds{};
+  std::uint64_t files = 0;
+  std::uint64_t bytes = 0;  // contents of all files
+  std::uint64_t cache_hits = 0;
+  std::uint64_t sections = 0;
+  std::uint64_t keys = 0;                      // key updates
+  std::uint64_t eval_type = 0;                 // calls of eval_type
+  std::map<std::string, std::uint64_t> types;  // typed values per type
+
+  std::uint64_t &At(const LoadPhase &phase) {
+    return nanoseconds[static_cast<std::size_t>(phase)];
+  }
+  void Add(const LoadPhase &phase, const std::uint64_t &duration) {
+    At(phase) += duration;
+  }
+  void Merge(const LoadStats &other);
+  py::dict ToDict() const;
+};
+
+// Adds the lifetime of the timer to a phase (stats nullptr -> no-op)
+class PhaseTimer {
+ public:
+  PhaseTimer(LoadStats *t_stats, const LoadPhase &t_phase)
+      : stats(t_stats), phase(t_phase) {
+    if (stats) begin = std::chrono::steady_clock::now();
+  }
+  ~PhaseTimer() {
+    if (stats) stats->Add(phase, Elapsed());
+  }
+  PhaseTimer(const PhaseTimer &) = delete;
+  PhaseTimer &operator=(const PhaseTimer &) = delete;
+
+  std::uint64_t Elapsed() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - begin)
+        .count();
+  }
+
+ private:
+  LoadStats *stats;
+  LoadPhase phase;
+  std::chrono::steady_clock::time_point begin;
+};
+}  // namespace ini
+
+#endif  // INST__CORNFLAKES_INI_STATS_HPP_
@@ -0,0 +1,79 @@
+// Copyright (c) 2022 Semjon Geist.
+#include <ini_stream.hpp>
+
+#include <stdexcept>
+
+//! Chunked reader for large ini files (bounded memory, 64-bit offsets)
+namespace ini {
+
+SectionReader::SectionReader(const std::string &path,
+                             std::size_t t_chunk_size)
+    : m_file(path, std::ios::in | std::ios::binary),
+      m_chunk_size(t_chunk_size ? t_chunk_size : STREAM_CHUNK_SIZE) {
+  if (!m_file.is_open()) {
+    throw std::runtime_error(path + " not a valid file! " +
+                             "Check the path and permissions.");
+  }
+}
+
+bool SectionReader::ReadChunk() {
+  if (m_eof) return false;
+  // drop the returned sections once per chunk (not per section)
+  m_buffer.erase(0, m_begin_idx);
+  m_scan_idx -= m_begin_idx;
+  m_begin_idx = 0;
+  const std::size_t size = m_buffer.size();
+  m_buffer.resize(size + m_chunk_size);
+  m_file.read(&m_buffer[size], static_cast<std::streamsize>(m_chunk_size));
+  const auto count = static_cast<std::size_t>(m_file.gcount());
+  m_buffer.resize(size + count);
+  if (count < m_chunk_size) m_eof = true;
+  return count > 0;
+}
+
+/// Next section of the file (header line + body, the part before the first
+/// header is returned as a section without header)
+///
+/// @param section text of the section
+/// @returns false at the end of the file
+bool SectionReader::Next(std::string *section) {
+  while (true) {
+    // a line starting with SECTION_OPEN_CHAR ends the current section
+    while (m_scan_idx < m_buffer.size()) {
+      if (m_scan_idx != m_begin_idx &&
+          m_buffer[m_scan_idx] == SECTION_OPEN_CHAR[0]) {
+        section->assign(m_buffer, m_begin_idx, m_scan_idx - m_begin_idx);
+        m_offset += m_scan_idx - m_begin_idx;
+        m_begin_idx = m_scan_idx;
+        return true;
+      }
+      const std::size_t line_end =
+          m_buffer.find(system_operations::NEWLINE, m_scan_idx);
+      if (line_end == std::string::npos) break;
+      m_scan_idx = line_end + 1;
+    }
+
+    if (!ReadChunk()) {
+      if (m_begin_idx == m_buffer.size()) return false;
+      m_offset += m_buffer.size() - m_begin_idx;
+      section->assign(m_buffer, m_begin_idx, std::string::npos);
+      m_buffer.clear();
+      m_begin_idx = 0;
+      m_scan_idx = 0;
+      return true;
+    }
+  }
+}
+
+/// Name of a section returned by SectionReader::Next
+///
+/// @param section text of the section
+/// @returns section name (empty for the part before the first header)
+std::string_view SectionName(const std::string_view &section) {
+  if (section.empty() || section.front() != SECTION_OPEN_CHAR[0]) return {};
+  const std::string_view name =
+      section.substr(1, section.find(system_operations::NEWLINE) - 1);
+  return name.substr(0, name.find(SECTION_CLOSE_CHAR[0]));
+}
+
+}  // namespace ini
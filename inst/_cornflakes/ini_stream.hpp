@@ -0,0 +1,40 @@
+// Copyright (c) 2022 Semjon Geist.
+#ifndef INST__CORNFLAKES_INI_STREAM_HPP_
+#define INST__CORNFLAKES_INI_STREAM_HPP_
+
+// clang-format off
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <ini_tokenizer.hpp>
+// clang-format on
+
+namespace ini {  // cppcheck-suppress syntaxError
+inline const std::size_t STREAM_CHUNK_SIZE = 1 << 20;
+
+// Reads an ini file section by section in chunks, only the current section
+// and one chunk are kept in memory
+class SectionReader {
+ public:
+  SectionReader(const std::string &path, std::size_t t_chunk_size);
+  bool Next(std::string *section);
+  std::uint64_t offset() const { return m_offset; }
+
+ private:
+  bool ReadChunk();
+  std::ifstream m_file;
+  std::size_t m_chunk_size;
+  std::string m_buffer;          // returned sections, current section and
+                                 // unread bytes (compacted per chunk)
+  std::size_t m_begin_idx = 0;   // first byte of the current section
+  std::size_t m_scan_idx = 0;    // next line of m_buffer to check
+  std::uint64_t m_offset = 0;    // bytes of the file returned as sections
+  bool m_eof = false;
+};
+
+std::string_view SectionName(const std::string_view &section);
+}  // namespace ini
+
+#endif  // INST__CORNFLAKES_INI_STREAM_HPP_
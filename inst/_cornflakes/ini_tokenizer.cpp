@@ -0,0 +1,229 @@
+// Copyright (c) 2022 Semjon Geist.
+#include <ini_tokenizer.hpp>
+
+#include <algorithm>
+
+//! Single pass tokenizer to index sections and keys of ini files
+namespace ini {
+
+// key / value pair of a line segment (segment_value -> first NEWVALUE)
+inline void AddEntry(const std::string_view &contents,
+                     const std::size_t &segment_begin,
+                     const std::size_t &segment_value,
+                     const std::size_t &segment_end,
+                     std::vector<KeyValueView> *entries) {
+  if (segment_value == std::string_view::npos ||
+      segment_value == segment_begin) {
+    return;
+  }
+  const std::string_view value = TrimView(
+      contents.substr(segment_value + 1, segment_end - segment_value - 1));
+  if (!value.empty()) {
+    entries->push_back(
+        {TrimView(contents.substr(segment_begin,
+                                  segment_value - segment_begin)),
+         value});
+  }
+}
+
+// walk the structural characters of a line: key / value of the line for
+// defined keys (comments are part of the value) and key / value pairs for
+// all keys (split by COMMENT_CHAR)
+inline std::size_t TokenizeLine(const std::string_view &contents,
+                                const StructuralIndex &structure,
+                                const std::size_t &line_begin,
+                                LineIndex *line,
+                                std::vector<KeyValueView> *entries) {
+  std::size_t line_end = contents.size();
+  std::size_t value_idx = std::string_view::npos;
+  std::size_t segment_begin = line_begin;
+  std::size_t segment_value = std::string_view::npos;
+
+  for (std::size_t pos = structure.Next(line_begin);
+       pos != std::string_view::npos; pos = structure.Next(pos + 1)) {
+    if (contents[pos] == system_operations::NEWLINE) {
+      line_end = pos;
+      break;
+    }
+    if (contents[pos] == NEWVALUE) {
+      if (value_idx == std::string_view::npos) value_idx = pos;
+      if (segment_value == std::string_view::npos) segment_value = pos;
+    } else {
+      AddEntry(contents, segment_begin, segment_value, pos, entries);
+      segment_begin = pos + 1;
+      segment_value = std::string_view::npos;
+    }
+  }
+  AddEntry(contents, segment_begin, segment_value, line_end, entries);
+
+  line->line = contents.substr(line_begin, line_end - line_begin);
+  if (value_idx == std::string_view::npos) {
+    line->key = TrimView(line->line);
+    line->value = line->line.substr(line->line.size());
+  } else {
+    line->key = TrimView(line->line.substr(0, value_idx - line_begin));
+    line->value = TrimView(line->line.substr(value_idx - line_begin + 1));
+  }
+  return line_end;
+}
+
+// physical line joined with the next one (trailing CONTINUATION_CHAR)
+inline bool EndsWithContinuation(std::string_view line) {
+  if (!line.empty() && line.back() == CARRIAGE_RETURN) line.remove_suffix(1);
+  return !line.empty() && line.back() == CONTINUATION_CHAR;
+}
+
+inline void JoinValue(std::string *value, const std::string_view &line,
+                      const bool &continuation) {
+  if (continuation) {
+    if (!value->empty() && value->back() == CARRIAGE_RETURN) value->pop_back();
+    if (!value->empty() && value->back() == CONTINUATION_CHAR) {
+      value->pop_back();
+    }
+  } else {
+    value->push_back(system_operations::NEWLINE);
+  }
+  value->append(line);
+}
+
+inline std::string_view StoreJoined(FileIndex *index, std::string value,
+                                    const char *origin) {
+  const std::string_view result = index->joined.emplace_back(std::move(value));
+  index->joined_origin.emplace(result.data(), origin);
+  return result;
+}
+
+// join indented continuation lines ("\n" + trimmed line) and lines after a
+// trailing CONTINUATION_CHAR (joined directly) into the value of a line
+inline std::size_t JoinContinuations(const std::string_view &contents,
+                                     std::size_t line_end,
+                                     const std::size_t &entries_begin,
+                                     LineIndex *line, FileIndex *index,
+                                     std::size_t *continuations) {
+  KeyValueView *entry = index->entries.size() > entries_begin
+                            ? &index->entries.back()
+                            : nullptr;
+  std::string_view physical = line->line;
+  std::string value, entry_value;
+
+  while (line_end < contents.size()) {
+    const std::size_t next_begin = line_end + 1;
+    const std::size_t next_end =
+        std::min(contents.find(system_operations::NEWLINE, next_begin),
+                 contents.size());
+    const std::string_view next =
+        contents.substr(next_begin, next_end - next_begin);
+    const std::string_view next_value = TrimView(next);
+    const bool continuation = EndsWithContinuation(physical);
+    if (!continuation &&
+        (next_value.empty() || !IsWhitespace(next.front()))) {
+      break;
+    }
+
+    if (!*continuations) {
+      value = line->value;
+      if (entry) entry_value = entry->value;
+    }
+    JoinValue(&value, next_value, continuation);
+    if (entry) JoinValue(&entry_value, next_value, continuation);
+    physical = next;
+    line_end = next_end;
+    ++*continuations;
+  }
+
+  if (*continuations) {
+    const bool same_value = entry && entry_value == value;
+    line->value = StoreJoined(index, std::move(value), line->line.data());
+    if (same_value) {
+      entry->value = line->value;
+    } else if (entry) {
+      entry->value =
+          StoreJoined(index, std::move(entry_value), line->line.data());
+    }
+  }
+  return line_end;
+}
+
+inline void AddKey(const LineIndex &line, KeyIndex *keys) {
+  if (line.key.empty() || line.value.empty()) return;
+  (*keys)[line.key] = line.value;
+}
+
+/// Tokenize ini contents with a single walk over the structural characters
+///
+/// @param contents ini file contents (shared, never copied)
+/// @param multiline join continuation lines into their values
+/// @returns index of lines, key / value pairs and sections
+std::shared_ptr<const FileIndex> TokenizeFile(
+    std::shared_ptr<const system_operations::FileBuffer> contents,
+    bool multiline) {
+  auto index = std::make_shared<FileIndex>();
+  index->contents = std::move(contents);
+  index->multiline = multiline;
+  const std::string_view view = index->contents->view();
+  const StructuralIndex structure(view);
+  SectionIndex *section = nullptr;
+
+  std::size_t line_begin = 0;
+  while (line_begin < view.size()) {
+    LineIndex line;
+    const std::size_t entries_begin = index->entries.size();
+    index->line_entries.push_back(entries_begin);
+    std::size_t line_end = TokenizeLine(view, structure, line_begin, &line,
+                                        &index->entries);
+    const bool is_header =
+        !line.line.empty() && line.line.front() == SECTION_OPEN_CHAR[0];
+    std::size_t continuations = 0;
+    if (multiline && !is_header && !line.value.empty()) {
+      line_end = JoinContinuations(view, line_end, entries_begin, &line,
+                                   index.get(), &continuations);
+    }
+
+    if (is_header) {
+      if (section) section->line_cursor[1] = index->lines.size();
+      SectionIndex next_section;
+      next_section.name = line.line.substr(1);
+      next_section.name = next_section.name.substr(
+          0, next_section.name.find(SECTION_CLOSE_CHAR[0]));
+      next_section.line_cursor = {index->lines.size() + 1,
+                                  index->lines.size() + 1};
+      index->sections.push_back(std::move(next_section));
+      section = &index->sections.back();
+      index->section_lookup.emplace(section->name,
+                                    index->sections.size() - 1);
+    } else if (section) {
+      AddKey(line, &section->keys);
+    }
+
+    index->lines.push_back(line);
+    // continuation lines are part of the value above
+    for (std::size_t idx = 0; idx < continuations; ++idx) {
+      index->line_entries.push_back(index->entries.size());
+      index->lines.emplace_back();
+    }
+    line_begin = line_end + 1;
+  }
+  index->line_entries.push_back(index->entries.size());
+  if (section) section->line_cursor[1] = index->lines.size();
+
+  return index;
+}
+
+/// Build the key index for an arbitrary line range (e.g. default sections)
+KeyIndex BuildKeyIndex(const FileIndex &index,
+                       const std::array<std::size_t, 2> &line_cursor) {
+  KeyIndex keys;
+  for (std::size_t idx = line_cursor[0]; idx < line_cursor[1]; ++idx) {
+    AddKey(index.lines[idx], &keys);
+  }
+  return keys;
+}
+
+/// Range of key / value entries for a line range
+std::array<std::size_t, 2> EntryCursor(
+    const FileIndex &index, const std::array<std::size_t, 2> &line_cursor) {
+  return {index.line_entries[line_cursor[0]],
+          index.line_entries[line_cursor[1]]};
+}
+
+}  // namespace ini
@@ -0,0 +1,90 @@
+// Copyright (c) 2022 Semjon Geist.
+#ifndef INST__CORNFLAKES_INI_TOKENIZER_HPP_
+#define INST__CORNFLAKES_INI_TOKENIZER_HPP_
+
+// clang-format off
+#include <array>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <ini_scanner.hpp>
+#include <system_operations.hpp>
+// clang-format on
+
+namespace ini {  // cppcheck-suppress syntaxError
+// constants
+inline const char COMMENT_CHAR = '#';
+inline const char NEWVALUE = '=';
+inline const char WHITESPACE = ' ';
+inline const std::string SECTION_OPEN_CHAR = "[";
+inline const std::string SECTION_CLOSE_CHAR = "]";
+inline const std::string BEGIN_PATTERN = '\n' + SECTION_OPEN_CHAR;
+inline const char TAB = '\t';
+inline const char CONTINUATION_CHAR = '\\';
+inline const char CARRIAGE_RETURN = '\r';
+
+inline bool IsWhitespace(const char &value) {
+  return value == WHITESPACE || value == TAB;
+}
+
+inline std::string_view TrimView(std::string_view value) {
+  while (!value.empty() && IsWhitespace(value.front())) value.remove_prefix(1);
+  while (!value.empty() && IsWhitespace(value.back())) value.remove_suffix(1);
+  return value;
+}
+
+// key / value pair (both trimmed) as views into the file contents
+struct KeyValueView {
+  std::string_view key;
+  std::string_view value;
+};
+
+// key -> last non-empty value of a line range
+using KeyIndex = std::unordered_map<std::string_view, std::string_view>;
+
+// single line of the file (split by NEWLINE)
+struct LineIndex {
+  std::string_view line;   // raw line without NEWLINE
+  std::string_view key;    // trimmed text until the first NEWVALUE
+  std::string_view value;  // trimmed text after the first NEWVALUE
+};
+
+// section header with the line range of its body
+struct SectionIndex {
+  std::string_view name;
+  std::array<std::size_t, 2> line_cursor;  // first body line / end line
+  KeyIndex keys;                           // defined keys of the body
+};
+
+// Tokenized file (section -> key -> value views), built in a single pass.
+// All views point into the immutable (shared) contents.
+struct FileIndex {
+  std::shared_ptr<const system_operations::FileBuffer> contents;
+  std::vector<LineIndex> lines;
+  // key / value pairs for all keys (lines are additionally split by
+  // COMMENT_CHAR), line_entries[i] is the first entry of line i
+  std::vector<KeyValueView> entries;
+  std::vector<std::size_t> line_entries;
+  std::vector<SectionIndex> sections;
+  // section name -> first section with this name
+  std::unordered_map<std::string_view, std::size_t> section_lookup;
+  bool multiline = false;  // continuation lines joined into their value
+  // values joined from continuation lines -> their first line
+  std::deque<std::string> joined;
+  std::unordered_map<const char *, const char *> joined_origin;
+};
+
+std::shared_ptr<const FileIndex> TokenizeFile(
+    std::shared_ptr<const system_operations::FileBuffer> contents,
+    bool multiline = false);
+KeyIndex BuildKeyIndex(const FileIndex &index,
+                       const std::array<std::size_t, 2> &line_cursor);
+std::array<std::size_t, 2> EntryCursor(
+    const FileIndex &index, const std::array<std::size_t, 2> &line_cursor);
+}  // namespace ini
+
+#endif  // INST__CORNFLAKES_INI_TOKENIZER_HPP_
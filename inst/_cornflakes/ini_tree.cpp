@@ -0,0 +1,324 @@
+// Copyright (c) 2022 Semjon Geist.
+#include <ini_tree.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <stdexcept>
+
+//! Native typed values of parsed ini files (no python objects involved)
+namespace ini {
+// longest value eval_type parses as a native number
+inline const std::size_t MAX_NUMBER_SIZE = 18;
+// boolean spellings of typed (bool) keys
+inline const std::string TRUE_STRINGS[] = {"TRUE", "YES", "ON", "1"};
+inline const std::string FALSE_STRINGS[] = {"FALSE", "NO", "OFF", "0"};
+// python type names of the native alternatives of Value::data
+inline const char *const VALUE_TYPES[] = {"NoneType", "bool", "int",  "float",
+                                          "str",      "",     "list", "dict"};
+
+inline bool IsDigit(const char &value) {
+  return std::isdigit(static_cast<unsigned char>(value));
+}
+
+inline bool EqualsUpper(const std::string_view &value,
+                        const std::string &upper) {
+  if (value.size() != upper.size()) return false;
+  for (std::size_t idx = 0; idx < value.size(); ++idx) {
+    if (std::toupper(static_cast<unsigned char>(value[idx])) != upper[idx]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+inline bool IsNan(const std::string_view &value) {
+  for (const auto &nan_string : string_operations::NAN_STRINGS) {
+    if (EqualsUpper(value, nan_string)) return true;
+  }
+  return false;
+}
+
+// [+-]digits (integer) or [+-]digits.digits / .digits (float)
+inline bool ParseNumber(const std::string_view &value, Value *result) {
+  std::size_t idx = value[0] == '+' || value[0] == '-' ? 1 : 0;
+  const std::size_t digits_begin = idx;
+  while (idx < value.size() && IsDigit(value[idx])) ++idx;
+  const std::size_t integer_digits = idx - digits_begin;
+
+  if (idx == value.size()) {
+    if (!integer_digits) return false;
+    std::int64_t integer = 0;
+    for (std::size_t pos = digits_begin; pos < idx; ++pos) {
+      integer = integer * 10 + (value[pos] - '0');
+    }
+    result->data = value[0] == '-' ? -integer : integer;
+    return true;
+  }
+
+  // ".5" is numeric, "-.5" not (same as eval_type)
+  if (value[idx] != '.' || (digits_begin && !integer_digits)) return false;
+  const std::size_t fraction_begin = ++idx;
+  while (idx < value.size() && IsDigit(value[idx])) ++idx;
+  if (idx != value.size() || !(integer_digits + idx - fraction_begin)) {
+    return false;
+  }
+  double number = 0;
+  if (!string_operations::parse_double(value, &number)) return false;
+  result->data = number;
+  return true;
+}
+
+/// Classify a value without the GIL, mirrors eval_type for none, boolean,
+/// integer, float and string values; everything else is deferred
+///
+/// @param value trimmed value
+/// @param is_file_value value is a view into the file contents
+/// @returns native value
+Value ClassifyValue(const std::string_view &value, bool is_file_value) {
+  Value result;
+  std::string_view stripped = value;
+  if (stripped.empty()) return result;
+
+  if (stripped.size() > 1 &&
+      string_operations::is_quoted(stripped.front(), stripped.back())) {
+    stripped = stripped.substr(1, stripped.size() - 2);
+    if (stripped.empty()) return result;
+  }
+  if (stripped.size() == 1) {
+    if (IsDigit(stripped[0])) {
+      result.data = static_cast<std::int64_t>(stripped[0] - '0');
+    } else {
+      result.data = stripped;
+    }
+    return result;
+  }
+
+  const bool is_number =
+      std::string_view(string_operations::NUMBER_CHARS).find(stripped[0]) !=
+      std::string_view::npos;
+  if (is_number) {
+    if (stripped.size() <= MAX_NUMBER_SIZE && ParseNumber(stripped, &result)) {
+      return result;
+    }
+  } else if (stripped[0] != string_operations::ESCAPE_CHAR[0]) {
+    if (stripped.size() < 6) {
+      if (EqualsUpper(stripped, "TRUE")) {
+        result.data = true;
+        return result;
+      }
+      if (EqualsUpper(stripped, "FALSE")) {
+        result.data = false;
+        return result;
+      }
+    }
+    if (IsNan(stripped)) return result;
+
+    const bool is_json =
+        (stripped.front() == string_operations::JSON_CHARS[0] &&
+         stripped.back() == string_operations::JSON_CHARS[1]) ||
+        (stripped.front() == string_operations::ARRAY_CHARS[0] &&
+         stripped.back() == string_operations::ARRAY_CHARS[1]);
+    // 7 - 38 chars may be an ip address, uuid or datetime
+    if (!is_json && (stripped.size() <= 6 || stripped.size() >= 39)) {
+      result.data = stripped;
+      return result;
+    }
+  }
+
+  result.data = DeferredValue{value, is_file_value};
+  return result;
+}
+
+// deferred value through EvalTyped (typed keys) / eval_type
+inline py::object EvalDeferred(const DeferredValue &deferred,
+                               TypedValues *values) {
+  if (deferred.type != SchemaType::ANY) {
+    return EvalTyped(deferred.raw, deferred.type);
+  }
+  if (deferred.is_file_value) return values->Eval(deferred.raw);
+  return string_operations::eval_type(std::string(deferred.raw));
+}
+
+// EvalDeferred timed and counted per result type
+inline py::object EvalDeferred(const DeferredValue &deferred,
+                               TypedValues *values, LoadStats *stats) {
+  if (!stats) return EvalDeferred(deferred, values);
+  PhaseTimer timer(stats, LoadPhase::EVAL_TYPE);
+  py::object result = EvalDeferred(deferred, values);
+  ++stats->eval_type;
+  ++stats->types[Py_TYPE(result.ptr())->tp_name];
+  return result;
+}
+
+inline std::string_view Unquote(const std::string_view &value) {
+  if (value.size() > 1 &&
+      string_operations::is_quoted(value.front(), value.back())) {
+    return value.substr(1, value.size() - 2);
+  }
+  return value;
+}
+
+[[noreturn]] inline void InvalidValue(const std::string_view &key,
+                                      const std::string_view &value,
+                                      const SchemaType &type) {
+  throw std::invalid_argument("invalid " +
+                              std::string(SchemaTypeName(type)) + " value '" +
+                              std::string(value) + "' for key '" +
+                              std::string(key) + "'");
+}
+
+// [+-]digits / 0x hex digits, longer integers and the other spellings of
+// int() (1_000) are converted by python
+inline bool ParseInteger(const std::string_view &value, Value *result) {
+  const std::string number(value);
+  const bool is_hex = number.size() > 2 && number[0] == '0' &&
+                      std::toupper(static_cast<unsigned char>(number[1])) ==
+                          string_operations::HEX_CHAR[1];
+  std::size_t idx = number[0] == '+' || number[0] == '-' ? 1 : 0;
+  if (idx == number.size() || !IsDigit(number[idx])) return false;
+  if (!is_hex) {
+    const std::string_view digits = value.substr(idx);
+    std::uint64_t magnitude = 0;
+    if (!string_operations::parse_uint64(digits, &magnitude)) {
+      return std::all_of(digits.begin(), digits.end(), IsDigit);  // deferred
+    }
+    const bool negative = number[0] == string_operations::MINUS_CHAR;
+    if (magnitude > string_operations::MAX_NEGATIVE_MAGNITUDE - !negative) {
+      return true;  // deferred
+    }
+    result->data = negative ? -static_cast<std::int64_t>(magnitude - 1) - 1
+                            : static_cast<std::int64_t>(magnitude);
+    return true;
+  }
+  char *end = nullptr;
+  errno = 0;
+  const long long integer =  // NOLINT(runtime/int)
+      std::strtoll(number.c_str(), &end, is_hex ? 16 : 10);
+  if (*end != '\0' || errno == ERANGE) return false;
+  result->data = static_cast<std::int64_t>(integer);
+  return true;
+}
+
+inline bool ParseBool(const std::string_view &value, Value *result) {
+  for (const auto &item : TRUE_STRINGS) {
+    if (EqualsUpper(value, item)) {
+      result->data = true;
+      return true;
+    }
+  }
+  for (const auto &item : FALSE_STRINGS) {
+    if (EqualsUpper(value, item)) {
+      result->data = false;
+      return true;
+    }
+  }
+  return false;
+}
+
+/// Classify a value of a known type without the GIL (no inference), types
+/// without a native representation are deferred to EvalTyped
+///
+/// @param key key of the value (error message)
+/// @param value trimmed value
+/// @param type target type of the key
+/// @param is_file_value value is a view into the file contents
+/// @returns native value (None for empty / none values, raises
+/// std::invalid_argument for invalid values)
+Value ClassifyTyped(const std::string_view &key, const std::string_view &value,
+                    const SchemaType &type, bool is_file_value) {
+  Value result;
+  const std::string_view stripped = Unquote(value);
+  if (stripped.empty()) return result;
+  if (type == SchemaType::STR) {
+    result.data = stripped;
+    return result;
+  }
+  if (IsNan(stripped)) return result;
+
+  switch (type) {
+    case SchemaType::INT:
+      if (!ParseInteger(stripped, &result) || !result.data.index()) {
+        result.data = DeferredValue{stripped, is_file_value, type};
+      }
+      return result;
+    case SchemaType::FLOAT: {
+      // other spellings of float() (inf, nan, 1_000.5) are converted by python
+      double floating = 0;
+      if (string_operations::parse_double(stripped, &floating)) {
+        result.data = floating;
+      } else {
+        result.data = DeferredValue{stripped, is_file_value, type};
+      }
+      return result;
+    }
+    case SchemaType::BOOL:
+      if (!ParseBool(stripped, &result)) InvalidValue(key, value, type);
+      return result;
+    default:
+      result.data = DeferredValue{stripped, is_file_value, type};
+      return result;
+  }
+}
+
+/// Materialize a native value into a python object (needs the GIL)
+///
+/// @param value native value
+/// @param values typed values of the file (memo for deferred values)
+/// @param stats counts the values per type (nullptr -> not collected)
+/// @returns python object
+py::object ToPyObject(const Value &value, TypedValues *values,
+                      LoadStats *stats) {
+  if (stats && value.data.index() != 5) {
+    ++stats->types[VALUE_TYPES[value.data.index()]];
+  }
+  switch (value.data.index()) {
+    case 1:
+      return py::bool_(std::get<bool>(value.data));
+    case 2:
+      return py::int_(std::get<std::int64_t>(value.data));
+    case 3:
+      return py::float_(std::get<double>(value.data));
+    case 4: {
+      const auto &string = std::get<std::string_view>(value.data);
+      return py::str(string.data(), string.size());
+    }
+    case 5:
+      return EvalDeferred(std::get<DeferredValue>(value.data), values, stats);
+    case 6: {
+      py::list result;
+      for (const auto &item : std::get<ValueList>(value.data)) {
+        result.append(ToPyObject(item, values, stats));
+      }
+      return std::move(result);
+    }
+    case 7: {
+      py::dict result;
+      for (const auto &item : std::get<ValueDict>(value.data)) {
+        result[py::str(item.first.data(), item.first.size())] =
+            ToPyObject(item.second, values, stats);
+      }
+      return std::move(result);
+    }
+    default:
+      return py::none();
+  }
+}
+
+/// Python string of a name (created on the first use)
+///
+/// @param name section / key name
+/// @returns shared python string
+py::str PyNames::Get(const std::string_view &name) {
+  const auto name_iter = lookup.find(name);
+  if (name_iter != lookup.end()) return name_iter->second;
+  py::str result(name.data(), name.size());
+  if (lookup.size() < max_size) {
+    names.emplace_back(name);
+    lookup.emplace(names.back(), result);
+  }
+  return result;
+}
+
+}  // namespace ini
@@ -0,0 +1,97 @@
+// Copyright (c) 2022 Semjon Geist.
+#ifndef INST__CORNFLAKES_INI_TREE_HPP_
+#define INST__CORNFLAKES_INI_TREE_HPP_
+
+// clang-format off
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+#include <ini_cache.hpp>
+#include <ini_schema.hpp>
+// clang-format on
+
+namespace ini {  // cppcheck-suppress syntaxError
+// names kept by a PyNames table (bounded for long-lived parsers)
+inline const std::size_t PY_NAMES_MAX_SIZE = 4096;
+
+struct Value;
+using ValueList = std::vector<Value>;
+using ValueDict = std::vector<std::pair<std::string_view, Value>>;
+
+// raw value for types without a native representation (datetime, uuid, ip,
+// json, ...), evaluated by eval_type while materializing (needs the GIL)
+struct DeferredValue {
+  std::string_view raw;
+  bool is_file_value;  // view into the file contents -> memoized per file
+  SchemaType type = SchemaType::ANY;  // typed -> converted by EvalTyped
+};
+
+// Native typed value (std::monostate -> None)
+struct Value {
+  std::variant<std::monostate, bool, std::int64_t, double, std::string_view,
+               DeferredValue, ValueList, ValueDict>
+      data;
+};
+
+enum class UpdateType {
+  SET,       // section[key] = value
+  EXTEND,    // section[key] = section.get(key, []) + values (list)
+  UPDATE,    // section[key] = section.get(key, {}) | values (dict)
+  FALLBACK,  // environment / default value, if section.get(key) is None
+};
+
+// Single change of a section environment
+struct KeyUpdate {
+  UpdateType type;
+  std::string_view key;  // view into the file contents or the parser config
+  Value value;
+  bool has_value = true;  // FALLBACK: environment value found
+};
+
+enum class SectionTarget {
+  FILE,     // file environment itself
+  SECTION,  // file_envir.get(name, {})
+  DEFAULT,  // new dict at file_envir[None] (file without sections)
+};
+
+// Parsed section, updates are applied in order
+struct SectionTree {
+  SectionTarget target;
+  std::string_view name;
+  std::vector<KeyUpdate> updates;
+  std::vector<KeyUpdate> defaults_if_empty;  // section still empty -> applied
+};
+
+// Parsed file, built without the GIL and materialized into python later
+struct FileTree {
+  std::vector<SectionTree> sections;
+  std::deque<std::string> strings;  // interpolated values (stable views)
+};
+
+// Python strings of section / key names, each distinct name is created once
+// (the cached hash is reused by every dict it is inserted into)
+class PyNames {
+ public:
+  explicit PyNames(std::size_t t_max_size = PY_NAMES_MAX_SIZE)
+      : max_size(t_max_size) {}
+  py::str Get(const std::string_view &name);
+
+ private:
+  std::size_t max_size;
+  std::deque<std::string> names;  // owned names (stable views)
+  std::unordered_map<std::string_view, py::str> lookup;
+};
+
+Value ClassifyValue(const std::string_view &value, bool is_file_value = true);
+Value ClassifyTyped(const std::string_view &key, const std::string_view &value,
+                    const SchemaType &type, bool is_file_value = true);
+py::object ToPyObject(const Value &value, TypedValues *values,
+                      LoadStats *stats = nullptr);
+}  // namespace ini
+
+#endif  // INST__CORNFLAKES_INI_TREE_HPP_
@@ -0,0 +1,114 @@
+// Copyright (c) 2022 Semjon Geist.
+#include <ini_writer.hpp>
+
+#include <cstdint>
+
+//! Serializer of sections into ini bytes (read back by ini_load)
+namespace ini {
+
+inline bool IsPrintable(const std::string_view &value) {
+  for (const char &item : value) {
+    if (item < ' ' || item > '~') return false;
+  }
+  return true;
+}
+
+// repr() of a printable ascii string
+inline void WriteRepr(const std::string_view &value, std::string *out) {
+  const char quote = value.find('\'') != std::string_view::npos &&
+                             value.find('"') == std::string_view::npos
+                         ? '"'
+                         : '\'';
+  out->push_back(quote);
+  for (const char &item : value) {
+    if (item == quote || item == '\\') out->push_back('\\');
+    out->push_back(item);
+  }
+  out->push_back(quote);
+}
+
+inline void WriteObject(const py::handle &value, std::string *out) {
+  const std::string result = py::str(value);
+  out->append(result);
+}
+
+// repr(to_str(value)), native for none, bool, int, float and ascii strings
+void WriteValue(const py::handle &value, const py::object &to_str,
+                std::string *out) {
+  PyObject *ptr = value.ptr();
+  if (ptr == Py_None) return;
+  if (PyBool_Check(ptr)) {
+    out->append(ptr == Py_True ? "'True'" : "'False'");
+    return;
+  }
+  if (PyLong_CheckExact(ptr)) {
+    int overflow = 0;
+    const std::int64_t integer = PyLong_AsLongLongAndOverflow(ptr, &overflow);
+    if (!overflow) {
+      out->append(std::to_string(integer));
+      return;
+    }
+  } else if (PyFloat_CheckExact(ptr)) {
+    const std::string result = py::repr(value);
+    // scientific notation is rewritten by to_str
+    if (result.find('e') == std::string::npos) {
+      WriteRepr(result, out);
+      return;
+    }
+  } else if (PyUnicode_CheckExact(ptr)) {
+    Py_ssize_t size = 0;
+    const char *data = PyUnicode_AsUTF8AndSize(ptr, &size);
+    if (!data) throw py::error_already_set();
+    const std::string_view result(data, static_cast<std::size_t>(size));
+    if (IsPrintable(result)) {
+      WriteRepr(result, out);
+      return;
+    }
+  }
+  WriteObject(py::repr(to_str.is_none() ? py::object(py::str(value))
+                                        : to_str(value)),
+              out);
+}
+
+/// Serialize sections into ini bytes, the inverse of ini_load
+///
+/// @param sections iterable of (title, values, fields): values is a mapping
+/// (fields None) or an object whose fields are written in order
+/// @param to_str conversion of values without a native representation
+/// (cornflakes.common.type_to_str, None -> str)
+/// @returns "[title]\nkey=repr(to_str(value))\n...\n\n" for each section
+py::bytearray ini_dump(const py::iterable &sections, const py::object &to_str) {
+  std::string out;
+  for (const auto &section : sections) {
+    const py::tuple item(py::reinterpret_borrow<py::object>(section));
+    out.push_back(SECTION_OPEN_CHAR[0]);
+    WriteObject(item[0], &out);
+    out.push_back(SECTION_CLOSE_CHAR[0]);
+    out.push_back(system_operations::NEWLINE);
+
+    bool is_first = true;
+    const auto write_key = [&](const py::handle &key,
+                               const py::handle &value) {
+      if (!is_first) out.push_back(system_operations::NEWLINE);
+      is_first = false;
+      WriteObject(key, &out);
+      out.push_back(NEWVALUE);
+      WriteValue(value, to_str, &out);
+    };
+    if (item[2].is_none()) {
+      for (const auto &key_value : item[1].attr("items")()) {
+        const py::tuple pair(py::reinterpret_borrow<py::object>(key_value));
+        write_key(pair[0], pair[1]);
+      }
+    } else {
+      for (const auto &field : py::reinterpret_borrow<py::iterable>(item[2])) {
+        write_key(field, item[1].attr(field));
+      }
+    }
+    out.push_back(system_operations::NEWLINE);
+    out.push_back(system_operations::NEWLINE);
+  }
+  return {out.data(), out.size()};
+}
+
+}  // namespace ini
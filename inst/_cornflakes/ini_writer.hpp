@@ -0,0 +1,15 @@
+// Copyright (c) 2022 Semjon Geist.
+#ifndef INST__CORNFLAKES_INI_WRITER_HPP_
+#define INST__CORNFLAKES_INI_WRITER_HPP_
+
+// clang-format off
+#include <string>
+#include <ini_tokenizer.hpp>
+#include <string_operations.hpp>
+// clang-format on
+
+namespace ini {  // cppcheck-suppress syntaxError
+py::bytearray ini_dump(const py::iterable &sections, const py::object &to_str);
+}  // namespace ini
+
+#endif  // INST__CORNFLAKES_INI_WRITER_HPP_
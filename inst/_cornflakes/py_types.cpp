@@ -0,0 +1,171 @@
+// Copyright (c) 2022 Semjon Geist.
+#include <py_types.hpp>
+
+#include <datetime.h>
+
+//! Cached python types and datetime construction through the C API
+namespace string_operations {
+PyTypes *cached_types = nullptr;  // leaked on purpose (see PyTypes)
+
+/// Import the python types of the value conversions (needs the GIL, called
+/// once while the module is initialized)
+void init_py_types() {
+  if (cached_types) return;
+  PyDateTime_IMPORT;
+  if (!PyDateTimeAPI) throw py::error_already_set();
+
+  py::module builtins = py::module::import("builtins");
+  py::module datetime = py::module::import("datetime");
+  py::module ipaddress = py::module::import("ipaddress");
+  auto *types = new PyTypes();
+  types->int_type = builtins.attr("int");
+  types->float_type = builtins.attr("float");
+  types->decimal = py::module::import("decimal").attr("Decimal");
+  types->uuid = py::module::import("uuid").attr("UUID");
+  types->ipv4_address = ipaddress.attr("IPv4Address");
+  types->ipv6_address = ipaddress.attr("IPv6Address");
+  types->datetime = datetime.attr("datetime");
+  types->date = datetime.attr("date");
+  types->time = datetime.attr("time");
+  cached_types = types;
+}
+
+const PyTypes &py_types() {
+  if (!cached_types) init_py_types();
+  return *cached_types;
+}
+
+inline py::object Steal(PyObject *object) {
+  if (!object) throw py::error_already_set();
+  return py::reinterpret_steal<py::object>(object);
+}
+
+// timezone(timedelta(minutes=offset)), one instance per offset
+inline PyObject *Timezone(const int &offset) {
+  if (!offset) return PyDateTime_TimeZone_UTC;
+  auto &timezones = cached_types->timezones;
+  const auto timezone_iter = timezones.find(offset);
+  if (timezone_iter != timezones.end()) return timezone_iter->second.ptr();
+
+  const py::object delta = Steal(PyDelta_FromDSU(0, offset * 60, 0));
+  py::object timezone = Steal(PyTimeZone_FromOffset(delta.ptr()));
+  PyObject *result = timezone.ptr();
+  timezones.emplace(offset, std::move(timezone));
+  return result;
+}
+
+/// Timezone aware datetime (raises ValueError for invalid dates)
+///
+/// @param offset utc offset in minutes
+/// @returns datetime.datetime
+py::object make_datetime(int year, int month, int day, int hour, int minute,
+                         int second, int microsecond, int offset) {
+  py_types();
+  return Steal(PyDateTimeAPI->DateTime_FromDateAndTime(
+      year, month, day, hour, minute, second, microsecond, Timezone(offset),
+      PyDateTimeAPI->DateTimeType));
+}
+
+py::object make_date(int year, int month, int day) {
+  py_types();
+  return Steal(PyDate_FromDate(year, month, day));
+}
+
+/// Timezone aware time (raises ValueError for invalid times)
+///
+/// @param offset utc offset in minutes
+/// @returns datetime.time
+py::object make_time(int hour, int minute, int second, int microsecond,
+                     int offset) {
+  py_types();
+  return Steal(PyDateTimeAPI->Time_FromTime(hour, minute, second, microsecond,
+                                            Timezone(offset),
+                                            PyDateTimeAPI->TimeType));
+}
+
+// utc offset (minutes) of a tzinfo that make_datetime recreates as it is
+// (cached / equal timezone with the same name), false otherwise
+inline bool FixedOffset(PyObject *tzinfo, int *offset) {
+  const py::handle timezone(tzinfo);
+  const py::object delta = timezone.attr("utcoffset")(py::none());
+  if (!PyDelta_Check(delta.ptr()) ||
+      PyDateTime_DELTA_GET_MICROSECONDS(delta.ptr()) ||
+      PyDateTime_DELTA_GET_SECONDS(delta.ptr()) % 60) {
+    return false;
+  }
+  *offset = PyDateTime_DELTA_GET_DAYS(delta.ptr()) * 24 * 60 +
+            PyDateTime_DELTA_GET_SECONDS(delta.ptr()) / 60;
+  PyObject *canonical = Timezone(*offset);
+  if (tzinfo == canonical) return true;
+  const py::handle canonical_timezone(canonical);
+  return timezone.equal(canonical_timezone) &&
+         timezone.attr("tzname")(py::none())
+             .equal(canonical_timezone.attr("tzname")(py::none()));
+}
+
+/// Fields of an exact datetime / date / time, that make_datetime recreates
+///
+/// @param value python object
+/// @param fields result
+/// @returns false for other types, fold and timezones without a fixed offset
+/// of whole minutes
+bool datetime_fields(const py::handle &value, DateTimeFields *fields) {
+  py_types();
+  PyObject *object = value.ptr();
+  PyObject *tzinfo = Py_None;
+  if (PyDateTime_CheckExact(object)) {
+    if (PyDateTime_DATE_GET_FOLD(object)) return false;
+    fields->kind = DateTimeKind::DATETIME;
+    fields->hour = PyDateTime_DATE_GET_HOUR(object);
+    fields->minute = PyDateTime_DATE_GET_MINUTE(object);
+    fields->second = PyDateTime_DATE_GET_SECOND(object);
+    fields->microsecond = PyDateTime_DATE_GET_MICROSECOND(object);
+    const auto *datetime = reinterpret_cast<PyDateTime_DateTime *>(object);
+    if (datetime->hastzinfo) tzinfo = datetime->tzinfo;
+  } else if (PyDate_CheckExact(object)) {
+    fields->kind = DateTimeKind::DATE;
+  } else if (PyTime_CheckExact(object)) {
+    if (PyDateTime_TIME_GET_FOLD(object)) return false;
+    fields->kind = DateTimeKind::TIME;
+    fields->hour = PyDateTime_TIME_GET_HOUR(object);
+    fields->minute = PyDateTime_TIME_GET_MINUTE(object);
+    fields->second = PyDateTime_TIME_GET_SECOND(object);
+    fields->microsecond = PyDateTime_TIME_GET_MICROSECOND(object);
+    const auto *time = reinterpret_cast<PyDateTime_Time *>(object);
+    if (time->hastzinfo) tzinfo = time->tzinfo;
+  } else {
+    return false;
+  }
+  if (fields->kind != DateTimeKind::TIME) {
+    fields->year = PyDateTime_GET_YEAR(object);
+    fields->month = PyDateTime_GET_MONTH(object);
+    fields->day = PyDateTime_GET_DAY(object);
+  }
+  fields->has_offset = tzinfo != Py_None;
+  fields->offset = 0;
+  return !fields->has_offset || FixedOffset(tzinfo, &fields->offset);
+}
+
+/// Datetime / date / time of its fields (raises ValueError for invalid ones)
+///
+/// @param fields see datetime_fields
+/// @returns datetime.datetime, datetime.date or datetime.time
+py::object make_datetime(const DateTimeFields &fields) {
+  py_types();
+  PyObject *tzinfo = fields.has_offset ? Timezone(fields.offset) : Py_None;
+  switch (fields.kind) {
+    case DateTimeKind::DATE:
+      return make_date(fields.year, fields.month, fields.day);
+    case DateTimeKind::TIME:
+      return Steal(PyDateTimeAPI->Time_FromTime(
+          fields.hour, fields.minute, fields.second, fields.microsecond,
+          tzinfo, PyDateTimeAPI->TimeType));
+    default:
+      return Steal(PyDateTimeAPI->DateTime_FromDateAndTime(
+          fields.year, fields.month, fields.day, fields.hour, fields.minute,
+          fields.second, fields.microsecond, tzinfo,
+          PyDateTimeAPI->DateTimeType));
+  }
+}
+
+}  // namespace string_operations
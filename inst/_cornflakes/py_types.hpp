@@ -0,0 +1,62 @@
+// Copyright (c) 2022 Semjon Geist.
+#ifndef INST__CORNFLAKES_PY_TYPES_HPP_
+#define INST__CORNFLAKES_PY_TYPES_HPP_
+
+#include <pybind11/pybind11.h>
+
+// clang-format off
+#include <cstdint>
+#include <unordered_map>
+// clang-format on
+
+namespace py = pybind11;
+
+namespace string_operations {  // cppcheck-suppress syntaxError
+// Python types used per converted value, imported once (init_py_types in
+// PYBIND11_MODULE) and never released (they would be released after the
+// interpreter shut down otherwise)
+struct PyTypes {
+  py::object int_type;
+  py::object float_type;
+  py::object decimal;
+  py::object uuid;
+  py::object ipv4_address;
+  py::object ipv6_address;
+  py::object datetime;
+  py::object date;
+  py::object time;
+  std::unordered_map<int, py::object> timezones;  // per offset (minutes)
+};
+
+enum class DateTimeKind : std::uint8_t {
+  DATETIME,
+  DATE,
+  TIME,
+};
+
+// fields of a datetime.datetime / date / time (naive -> !has_offset)
+struct DateTimeFields {
+  DateTimeKind kind = DateTimeKind::DATETIME;
+  int year = 0;
+  int month = 0;
+  int day = 0;
+  int hour = 0;
+  int minute = 0;
+  int second = 0;
+  int microsecond = 0;
+  bool has_offset = false;
+  int offset = 0;  // utc offset in minutes
+};
+
+void init_py_types();
+const PyTypes &py_types();
+py::object make_datetime(int year, int month, int day, int hour, int minute,
+                         int second, int microsecond, int offset);
+py::object make_date(int year, int month, int day);
+py::object make_time(int hour, int minute, int second, int microsecond,
+                     int offset);
+bool datetime_fields(const py::handle &value, DateTimeFields *fields);
+py::object make_datetime(const DateTimeFields &fields);
+}  // namespace string_operations
+
+#endif  // INST__CORNFLAKES_PY_TYPES_HPP_
@@ -1,6 +1,7 @@
 // Copyright (c) 2022 Semjon Geist.
 
 #include <string_operations.hpp>
+#include <py_types.hpp>
 #define strtk_no_tr1_or_boost
 #include <datetime_utils.hpp>
 
@@ -192,10 +193,23 @@ std::string trim(const std::string &str, const std::string &whitespace) {
   return str.substr(strBegin, strRange);
 }
 
-std::uint64_t parse8Chars(const char *string) noexcept {
+// little endian load of 8 chars (a single load on little endian targets)
+inline std::uint64_t load8Chars(const char *string) noexcept {
   std::uint64_t chunk = 0;
-  std::memcpy(&chunk, string, sizeof(chunk));
+  for (int idx = 7; idx >= 0; --idx) {
+    chunk = chunk << 8 | static_cast<unsigned char>(string[idx]);
+  }
+  return chunk;
+}
 
+// all 8 chars of a chunk are '0' ... '9'
+inline bool is8Digits(std::uint64_t chunk) noexcept {
+  return !(((chunk & 0xf0f0f0f0f0f0f0f0) |
+            (((chunk + 0x0606060606060606) & 0xf0f0f0f0f0f0f0f0) >> 4)) ^
+           0x3333333333333333);
+}
+
+inline std::uint64_t parse8Digits(std::uint64_t chunk) noexcept {
   // 1-byte mask trick (works on 4 pairs of single digits)
   std::uint64_t lower_digits = (chunk & 0x0f000f000f000f00) >> 8;
   std::uint64_t upper_digits = (chunk & 0x000f000f000f000f) * 10;
@@ -214,10 +228,142 @@ std::uint64_t parse8Chars(const char *string) noexcept {
   return chunk;
 }
 
-std::uint64_t parse64(std::string_view s) noexcept {
-  std::uint64_t upper_digits = parse8Chars(s.data());
-  std::uint64_t lower_digits = parse8Chars(s.data() + 8);
-  return upper_digits * 100000000 + lower_digits;
+/// Parse decimal digits (8 digits per step) into an unsigned integer
+///
+/// @param digits decimal digits without sign
+/// @param result parsed integer
+/// @returns digits are 1 - 19 decimal digits (always fits into 64 bit)
+bool parse_uint64(const std::string_view &digits,
+                  std::uint64_t *result) noexcept {
+  if (digits.empty() || digits.size() > MAX_UINT64_DIGITS) return false;
+  std::uint64_t value = 0;
+  std::size_t idx = 0;
+  for (; idx + 8 <= digits.size(); idx += 8) {
+    const std::uint64_t chunk = load8Chars(digits.data() + idx);
+    if (!is8Digits(chunk)) return false;
+    value = value * 100000000 + parse8Digits(chunk);
+  }
+  for (; idx < digits.size(); ++idx) {
+    const unsigned digit = static_cast<unsigned char>(digits[idx]) - '0';
+    if (digit > 9) return false;
+    value = value * 10 + digit;
+  }
+  *result = value;
+  return true;
+}
+
+// correctly rounded conversion of a validated number (from_chars if
+// available, a classic locale stream otherwise)
+inline bool parse_double_slow(const std::string_view &value, double *result) {
+  const std::string_view number =
+      value[0] == PLUS_CHAR ? value.substr(1) : value;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+  const auto [end, error] =
+      std::from_chars(number.data(), number.data() + number.size(), *result);
+  if (error == std::errc::result_out_of_range) {
+    // overflow -> inf, underflow -> 0 (same as float())
+    const std::size_t exponent = number.find_first_of("eE");
+    const bool overflow = exponent == std::string_view::npos ||
+                          number[exponent + 1] != MINUS_CHAR;
+    *result = overflow ? std::numeric_limits<double>::infinity() : 0.0;
+    if (number[0] == MINUS_CHAR) *result = -*result;
+    return true;
+  }
+  return error == std::errc() && end == number.data() + number.size();
+#else
+  std::istringstream stream{std::string(number)};
+  stream.imbue(std::locale::classic());
+  stream >> *result;
+  return !stream.fail() && stream.peek() == EOF;
+#endif
+}
+
+/// Parse a decimal number ([+-]digits[.digits][e[+-]digits]) independent of
+/// the locale, exact cases (mantissa up to 2^53 and a power of ten up to
+/// 1e22) are computed in a single floating point operation
+///
+/// @param value number
+/// @param result parsed number
+/// @returns value is a valid number
+bool parse_double(const std::string_view &value, double *result) {
+  const std::size_t size = value.size();
+  std::size_t idx = 0;
+  const bool negative = size && value[0] == MINUS_CHAR;
+  if (size && (negative || value[0] == PLUS_CHAR)) ++idx;
+
+  std::uint64_t mantissa = 0;
+  std::int64_t exponent = 0;
+  std::size_t significant_digits = 0;
+  std::size_t digits = 0;
+  auto add_digit = [&](const char &item) {
+    ++digits;
+    if (!mantissa && item == '0') return;  // leading zero
+    if (++significant_digits <= MAX_UINT64_DIGITS) {
+      mantissa = mantissa * 10 + static_cast<unsigned>(item - '0');
+    }
+  };
+  for (; idx < size && std::isdigit(static_cast<unsigned char>(value[idx]));
+       ++idx) {
+    add_digit(value[idx]);
+  }
+  if (idx < size && value[idx] == '.') {
+    for (++idx;
+         idx < size && std::isdigit(static_cast<unsigned char>(value[idx]));
+         ++idx) {
+      add_digit(value[idx]);
+      --exponent;
+    }
+  }
+  if (!digits) return false;
+
+  if (idx < size && (value[idx] == 'e' || value[idx] == 'E')) {
+    ++idx;
+    const bool negative_exponent = idx < size && value[idx] == MINUS_CHAR;
+    if (idx < size && (negative_exponent || value[idx] == PLUS_CHAR)) ++idx;
+    if (idx == size) return false;
+    std::int64_t exponent_value = 0;
+    for (; idx < size && std::isdigit(static_cast<unsigned char>(value[idx]));
+         ++idx) {
+      if (exponent_value < MAX_EXPONENT) {
+        exponent_value = exponent_value * 10 + (value[idx] - '0');
+      }
+    }
+    exponent += negative_exponent ? -exponent_value : exponent_value;
+  }
+  if (idx != size) return false;
+
+  // Clinger's fast path (both operands and the result are exact)
+  if (significant_digits <= MAX_UINT64_DIGITS &&
+      mantissa <= MAX_EXACT_MANTISSA && exponent >= -MAX_EXACT_POWER &&
+      exponent <= MAX_EXACT_POWER) {
+    double number = static_cast<double>(mantissa);
+    if (exponent < 0) {
+      number /= EXACT_POWERS_OF_TEN[-exponent];
+    } else {
+      number *= EXACT_POWERS_OF_TEN[exponent];
+    }
+    *result = negative ? -number : number;
+    return true;
+  }
+  return parse_double_slow(value, result);
+}
+
+// [+-]digits as python int, 64 bit values directly, longer values by the
+// arbitrary precision conversion of the C API
+inline py::object eval_integer(const std::string &value) {
+  const bool negative = value[0] == MINUS_CHAR;
+  const std::size_t sign = negative || value[0] == PLUS_CHAR ? 1 : 0;
+  std::uint64_t magnitude = 0;
+  if (parse_uint64(std::string_view(value).substr(sign), &magnitude)) {
+    if (!negative) return py::int_(magnitude);
+    if (magnitude <= MAX_NEGATIVE_MAGNITUDE) {
+      return py::int_(magnitude ? -static_cast<std::int64_t>(magnitude - 1) - 1
+                                : 0);
+    }
+  }
+  PyObject *integer = PyLong_FromString(value.c_str(), nullptr, 10);
+  if (!integer) throw py::error_already_set();
+  return py::reinterpret_steal<py::object>(integer);
 }
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -288,31 +434,22 @@ dt_utils::time_format12 time_format12(global_dt);
 #endif /* DOXYGEN_SHOULD_SKIP_THIS */
 
 py::object get_global_datetime() {
-  return py::module::import("datetime")
-      .attr("datetime")(
-          global_dt.year, global_dt.month, global_dt.day, global_dt.hour,
-          global_dt.minute, global_dt.second,
-          global_dt.microsecond ? global_dt.microsecond
-                                : global_dt.millisecond * 1000,
-          py::module::import("datetime")
-              .attr("timezone")(py::module::import("datetime")
-                                    .attr("timedelta")(0, global_dt.tzd * 60)));
+  return make_datetime(global_dt.year, global_dt.month, global_dt.day,
+                       global_dt.hour, global_dt.minute, global_dt.second,
+                       global_dt.microsecond ? global_dt.microsecond
+                                             : global_dt.millisecond * 1000,
+                       global_dt.tzd);
 }
 
 py::object get_global_date() {
-  return py::module::import("datetime")
-      .attr("date")(global_dt.year, global_dt.month, global_dt.day);
+  return make_date(global_dt.year, global_dt.month, global_dt.day);
 }
 
 py::object get_global_time() {
-  return py::module::import("datetime")
-      .attr("time")(
-          global_dt.hour, global_dt.minute, global_dt.second,
-          global_dt.microsecond ? global_dt.microsecond
-                                : global_dt.millisecond * 1000,
-          py::module::import("datetime")
-              .attr("timezone")(py::module::import("datetime")
-                                    .attr("timedelta")(0, global_dt.tzd * 60)));
+  return make_time(global_dt.hour, global_dt.minute, global_dt.second,
+                   global_dt.microsecond ? global_dt.microsecond
+                                         : global_dt.millisecond * 1000,
+                   global_dt.tzd);
 }
 
 py::object to_generic_datetime(const std::string &value) {
@@ -482,16 +619,281 @@ void preprocessJsonInPlace(std::string &input) {  // NOLINT
 }
 //// clang-format on
 
+// character classes of the value classifier
+enum CharClass : std::uint8_t {
+  CHAR_DIGIT = 1,  // 0-9
+  CHAR_HEX = 2,    // 0-9 a-f A-F
+  CHAR_SIGN = 4,   // + -
+  CHAR_LINE = 8,   // \r \n (not matched by . of the former regex)
+};
+
+constexpr std::array<std::uint8_t, 256> CharClasses() {
+  std::array<std::uint8_t, 256> classes{};
+  for (int idx = '0'; idx <= '9'; ++idx) classes[idx] = CHAR_DIGIT | CHAR_HEX;
+  for (int idx = 'a'; idx <= 'f'; ++idx) classes[idx] = CHAR_HEX;
+  for (int idx = 'A'; idx <= 'F'; ++idx) classes[idx] = CHAR_HEX;
+  classes['+'] = CHAR_SIGN;
+  classes['-'] = CHAR_SIGN;
+  classes['\r'] = CHAR_LINE;
+  classes['\n'] = CHAR_LINE;
+  return classes;
+}
+inline constexpr std::array<std::uint8_t, 256> CHAR_CLASSES = CharClasses();
+
+// candidates of a value (dropped while scanning)
+enum ValueCandidate : unsigned {
+  CANDIDATE_NUMBER = 1,
+  CANDIDATE_HEX = 2,
+  CANDIDATE_UUID = 4,
+  CANDIDATE_IPV4 = 8,
+};
+
+// [+-]digits[.tail] / .tail, where tail is digits or anything ending with
+// e- followed by digits (same language as the former numeric regex)
+class NumberState {
+ public:
+  bool Step(const char &item, const std::uint8_t &item_class) {
+    switch (state) {
+      case START:
+        if (item_class & CHAR_SIGN) {
+          state = SIGN;
+          return true;
+        }
+        [[fallthrough]];
+      case SIGN:
+      case INTEGER:
+        if (item_class & CHAR_DIGIT) {
+          state = INTEGER;
+          has_digit = true;
+          return true;
+        }
+        if (item != '.' || state == SIGN) return false;
+        state = TAIL_DIGITS;
+        return true;
+      default:
+        return StepTail(item, item_class);
+    }
+  }
+  // a digit before / right after the dot is required ("." is no number)
+  bool Accept() const {
+    return has_digit &&
+           (state == INTEGER || state == TAIL_DIGITS || state == TAIL_EXP);
+  }
 
+ private:
+  bool StepTail(const char &item, const std::uint8_t &item_class) {
+    if (item_class & CHAR_LINE) return false;
+    if (item_class & CHAR_DIGIT) {
+      if (state == TAIL_DIGITS) has_digit = true;
+      if (state == TAIL_E) state = TAIL_OTHER;
+    } else if (item == 'e') {
+      state = TAIL_E;
+    } else {
+      state = item == '-' && state == TAIL_E ? TAIL_EXP : TAIL_OTHER;
+    }
+    return true;
+  }
 
+  enum {
+    START,
+    SIGN,
+    INTEGER,
+    TAIL_DIGITS,  // digits after the dot
+    TAIL_OTHER,   // anything after the dot
+    TAIL_E,       // ... e
+    TAIL_EXP,     // ... e- digits
+  } state = START;
+  bool has_digit = false;
+};
+
+// 0-255 without leading zeros, four octets
+class Ipv4State {
+ public:
+  bool Step(const char &item, const std::uint8_t &item_class) {
+    if (item == '.') {
+      if (!digits || ++dots > 3) return false;
+      digits = octet = 0;
+      return true;
+    }
+    if (!(item_class & CHAR_DIGIT) || (digits && !octet)) return false;
+    octet = octet * 10 + (item - '0');
+    return ++digits <= 3 && octet <= 255;
+  }
+  bool Accept() const { return dots == 3 && digits; }
+
+ private:
+  int dots = 0;
+  int digits = 0;  // of the current octet
+  int octet = 0;
+};
+
+inline const std::size_t UUID_SIZE = 36;
+
+// 8-4-4-4-12 hex digits, version 0-5, variant 0 / 8 / 9 / a / b
+inline bool UuidStep(const std::size_t &idx, const char &item,
+                     const std::uint8_t &item_class) {
+  switch (idx) {
+    case 8:
+    case 13:
+    case 18:
+    case 23:
+      return item == '-';
+    case 14:
+      return item >= '0' && item <= '5';
+    case 19:
+      return item == '0' || item == '8' || item == '9' ||
+             std::tolower(static_cast<unsigned char>(item)) == 'a' ||
+             std::tolower(static_cast<unsigned char>(item)) == 'b';
+    default:
+      return item_class & CHAR_HEX;
+  }
+}
+
+inline bool EqualsUpper(const std::string_view &value,
+                        const std::string_view &upper) {
+  if (value.size() != upper.size()) return false;
+  for (std::size_t idx = 0; idx < value.size(); ++idx) {
+    if (std::toupper(static_cast<unsigned char>(value[idx])) != upper[idx]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Classify a value in a single scan over its bytes (number, hex, boolean,
+/// uuid, ipv4 or anything else), without regular expressions
+///
+/// @param value unquoted value
+/// @returns kind of the value
+ValueKind classify_value(const std::string_view &value) {
+  const std::size_t size = value.size();
+  if (size == 4 && EqualsUpper(value, "TRUE")) return ValueKind::BOOL_TRUE;
+  if (size == 5 && EqualsUpper(value, "FALSE")) return ValueKind::BOOL_FALSE;
+
+  unsigned candidates = CANDIDATE_NUMBER;
+  if (size > 2 && value[0] == HEX_CHAR[0] &&
+      std::toupper(static_cast<unsigned char>(value[1])) == HEX_CHAR[1]) {
+    candidates |= CANDIDATE_HEX;
+  }
+  if (size == UUID_SIZE) candidates |= CANDIDATE_UUID;
+  if (size >= 7 && size <= 15) candidates |= CANDIDATE_IPV4;
+
+  NumberState number;
+  Ipv4State ipv4;
+  for (std::size_t idx = 0; idx < size && candidates; ++idx) {
+    const char item = value[idx];
+    const std::uint8_t item_class =
+        CHAR_CLASSES[static_cast<unsigned char>(item)];
+    if ((candidates & CANDIDATE_NUMBER) && !number.Step(item, item_class)) {
+      candidates &= ~CANDIDATE_NUMBER;
+    }
+    if ((candidates & CANDIDATE_HEX) && idx > 1 && !(item_class & CHAR_HEX)) {
+      candidates &= ~CANDIDATE_HEX;
+    }
+    if ((candidates & CANDIDATE_UUID) && !UuidStep(idx, item, item_class)) {
+      candidates &= ~CANDIDATE_UUID;
+    }
+    if ((candidates & CANDIDATE_IPV4) && !ipv4.Step(item, item_class)) {
+      candidates &= ~CANDIDATE_IPV4;
+    }
+  }
+
+  if ((candidates & CANDIDATE_NUMBER) && number.Accept()) {
+    return ValueKind::NUMBER;
+  }
+  if (candidates & CANDIDATE_HEX) return ValueKind::HEX;
+  if (candidates & CANDIDATE_UUID) return ValueKind::UUID;
+  if ((candidates & CANDIDATE_IPV4) && ipv4.Accept()) return ValueKind::IPV4;
+  return ValueKind::STRING;
+}
+
+// Python objects of rapidjson SAX events (raw numbers -> exact integers as
+// in python), string leaves optionally evaluated by eval_type
+class PyJsonHandler
+    : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, PyJsonHandler> {
+ public:
+  explicit PyJsonHandler(bool t_recursive) : recursive(t_recursive) {}
+
+  bool Null() { return Add(py::none()); }
+  bool Bool(bool value) { return Add(py::bool_(value)); }
+  bool RawNumber(const char *value, rapidjson::SizeType size, bool) {
+    const std::string number(value, size);
+    if (number.find_first_of(".eE") == std::string::npos) {
+      return Add(eval_integer(number));
+    }
+    double result = 0;
+    return parse_double(number, &result) && Add(py::float_(result));
+  }
+  bool String(const char *value, rapidjson::SizeType size, bool) {
+    if (recursive) return Add(eval_type(std::string(value, size), true));
+    return Add(py::str(value, size));
+  }
+  bool StartObject() {
+    containers.push_back({py::dict(), py::list(), py::str(), true});
+    return true;
+  }
+  bool Key(const char *value, rapidjson::SizeType size, bool) {
+    containers.back().key = py::str(value, size);
+    return true;
+  }
+  bool EndObject(rapidjson::SizeType) { return End(); }
+  bool StartArray() {
+    containers.push_back({py::dict(), py::list(), py::str(), false});
+    return true;
+  }
+  bool EndArray(rapidjson::SizeType) { return End(); }
+
+  py::object result;
+
+ private:
+  struct Container {
+    py::dict dict;
+    py::list list;
+    py::str key;  // key of the next dict value
+    bool is_dict;
+  };
+
+  bool Add(const py::object &value) {
+    if (containers.empty()) {
+      result = value;
+    } else if (containers.back().is_dict) {
+      containers.back().dict[containers.back().key] = value;
+    } else {
+      containers.back().list.append(value);
+    }
+    return true;
+  }
+  bool End() {
+    const Container container = std::move(containers.back());
+    containers.pop_back();
+    if (container.is_dict) return Add(container.dict);
+    return Add(container.list);
+  }
+
+  bool recursive;
+  std::vector<Container> containers;
+};
+
+// python object of a json text in a single pass (no object -> invalid json)
+inline py::object json_to_py(const std::string &json, const bool &recursive) {
+  PyJsonHandler handler(recursive);
+  rapidjson::Reader reader;  // per call (no shared parser state)
+  rapidjson::StringStream stream(json.c_str());
+  if (reader.Parse<rapidjson::kParseNumbersAsStringsFlag>(stream, handler)
+          .IsError()) {
+    return py::object();
+  }
+  return std::move(handler.result);
+}
 
 /// This is a simple C++ function to cast strings into python objects with
 /// specific type
 ///
 /// @param value string to cast
+/// @param recursive evaluate the string values of json objects / arrays
 /// @returns python object (none, boolean, int, time, date, datetime,
-/// datetime_ms, ip_address)
-py::object eval_type(std::string value) {
+/// datetime_ms, ip_address, dict, list)
+py::object eval_type(std::string value, bool recursive) {
   if (value.empty()) {
     return py::none();
   }
@@ -518,32 +920,19 @@ py::object eval_type(std::string value) {
     }
   }
 
-  // parse numeric
-  if (std::regex_match(value, numeric_regex)) {
-    if (value.find_first_of('.') != std::string::npos || value.back() == '.') {
-      if (char_size > 18) {
-        return (py::module::import("decimal").attr("Decimal")(value));
-      }
-
-      // parse double
-      return (py::cast(std::stod(value)));
-    }
+  const ValueKind kind = classify_value(value);
 
-    // parse numeric
-    if (value[0] == MINUS_CHAR) {
-      value = value.erase(0, 1);
-      uint64_t integer = parse64(value.c_str());
-      if (integer < UINT_MAX) {
-        return (py::cast(-integer));
-      }
-      return (-py::module::import("builtins").attr("int")(value));
+  // parse numeric
+  if (kind == ValueKind::NUMBER) {
+    if (value.find_first_of('.') == std::string::npos) {
+      return eval_integer(value);
     }
-
-    uint64_t integer = parse64(value.c_str());
-    if (integer < UINT_MAX) {
-      return (py::cast(integer));
+    if (char_size > 18) {
+      return (py_types().decimal(value));
     }
-    return (py::module::import("builtins").attr("int")(value));
+    // parse double (values with a malformed exponent are no numbers)
+    double number = 0;
+    if (parse_double(value, &number)) return py::float_(number);
   }
 
   if (value.length() <= 2 && value[0] == ESCAPE_CHAR[0]) {
@@ -559,32 +948,20 @@ py::object eval_type(std::string value) {
   }
 
   // is hex char
-  if (value.length() <= 4 && value[0] == HEX_CHAR[0] &&
-      std::toupper(value[1]) == HEX_CHAR[1] &&
-      std::regex_match(value, hex_regex)) {
+  if (value.length() <= 4 && kind == ValueKind::HEX) {
     return py::cast(std::stoul(value, nullptr, 16));
   }
 
-  const char upper_first_char = static_cast<char>(std::toupper(value[0]));
-
   // boolean true or boolan false
-  if (char_size < 6 &&
-      (upper_first_char == TRUE_CHAR || upper_first_char == FALSE_CHAR)) {
-    if (std::regex_match(value, boolen_true_regex)) {
-      return (py::cast(true));
-    }
-
-    if (std::regex_match(value, boolen_false_regex)) {
-      return (py::cast(false));
-    }
-  }
+  if (kind == ValueKind::BOOL_TRUE) return (py::cast(true));
+  if (kind == ValueKind::BOOL_FALSE) return (py::cast(false));
 
   if (is_nan(value)) {
     return (py::cast<py::none>(Py_None));
   }
 
-  if (char_size == 36 && std::regex_match(value, uuid_regex)) {
-    return (py::module::import("uuid").attr("UUID")(value));
+  if (kind == ValueKind::UUID) {
+    return (py_types().uuid(value));
   }
 
   const char last_char = value.back();
@@ -594,10 +971,8 @@ py::object eval_type(std::string value) {
     std::string json_value =
         replace_all(value, ESCAPE_CHAR, PYTHON_ESCAPE_CHAR);
     preprocessJsonInPlace(json_value);
-    if (!json_doc.Parse(const_cast<char *>(json_value.c_str()))
-             .HasParseError()) {
-      return py::eval(json_value);
-    }
+    py::object result = json_to_py(json_value, recursive);
+    if (result) return result;
   }
 
   if (char_size < 6) {
@@ -608,14 +983,13 @@ py::object eval_type(std::string value) {
   // ipv4
   if (char_size < 39 && char_size > 6) {
     // ipv4
-    if (std::count(value.begin(), value.end(), '.') == 3 &&
-        std::regex_match(value, ipv4_regex)) {
-      return (py::module::import("ipaddress").attr("IPv4Address")(value));
+    if (kind == ValueKind::IPV4) {
+      return (py_types().ipv4_address(value));
     }
     // ipv6
     if (std::count(value.begin(), value.end(), ':') > 5) {
       try {
-        return (py::module::import("ipaddress").attr("IPv6Address")(value));
+        return (py_types().ipv6_address(value));
       } catch (...) {
       }
     }
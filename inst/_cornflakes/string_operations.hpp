@@ -12,13 +12,18 @@
 #include <writer.h>
 
 #include <algorithm>
+#include <array>
+#include <charconv>
 #include <chrono>
+#include <cstdint>
 #include <iostream>
+#include <limits>
+#include <locale>
 #include <map>
-#include <regex>
 #include <set>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -34,7 +39,7 @@ namespace string_operations {  // cppcheck-suppress syntaxError
 //    inline const char NULL_CHAR = '0';
 inline const char *QUOTE_CHARS = "\"\'";
 inline const char MINUS_CHAR = '-';
-//    inline const char PLUS_CHAR = '+';
+inline const char PLUS_CHAR = '+';
 inline const char *HEX_CHAR = "0X";
 inline const char TRUE_CHAR = 'T';
 inline const char FALSE_CHAR = 'F';
@@ -44,21 +49,28 @@ inline const std::string COLUM_SEPERATORS = ",;\t|\b";
 inline const std::string SPECIAL_CHARS = LINE_SEPERATORS + COLUM_SEPERATORS;
 inline const std::vector<std::string> NAN_STRINGS = {
     "NA", "NONE", "NULL", "UNDEFINED", "NONETYPE", "\"\""};
-inline const std::regex hex_regex = std::regex("0[xX][0-9a-fA-F]+");
-inline const std::regex boolen_true_regex =
-    std::regex("true", std::regex::icase);
-inline const std::regex boolen_false_regex =
-    std::regex("false", std::regex::icase);
-inline const std::regex numeric_regex =
-    std::regex("(^([+-]?\\d[0-9]*)?(\\.(.*e-)?)?([0-9]*)?$)");
-static const std::regex uuid_regex(
-    "^[0-9a-f]{8}-[0-9a-f]{4}-[0-5][0-9a-f]{3}-["
-    "089ab][0-9a-f]{3}-[0-9a-f]{12}$",
-    std::regex_constants::icase);
-static const std::regex ipv4_regex(
-    R"(^((25[0-5]|(2[0-4]|1\d|[1-9]|)\d)\.){3}(25[0-5]|(2[0-4]|1\d|[1-9]|)\d)$)");
-
-inline rapidjson::Document json_doc;
+// integers with up to 19 digits always fit into 64 bit
+inline const std::size_t MAX_UINT64_DIGITS = 19;
+inline const std::uint64_t MAX_NEGATIVE_MAGNITUDE = 1ULL << 63;
+// doubles represent integers up to 2^53 and powers of ten up to 1e22 exactly
+inline const std::uint64_t MAX_EXACT_MANTISSA = 1ULL << 53;
+inline const std::int64_t MAX_EXACT_POWER = 22;
+inline constexpr double EXACT_POWERS_OF_TEN[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+inline const std::int64_t MAX_EXPONENT = 100000;  // beyond -> inf / 0
+
+// Kind of a value (see classify_value)
+enum class ValueKind : std::uint8_t {
+  STRING,
+  NUMBER,  // [+-]digits[.digits]
+  HEX,     // 0x...
+  BOOL_TRUE,
+  BOOL_FALSE,
+  UUID,
+  IPV4,
+};
+
 inline std::string ESCAPE_CHAR = "\\";
 inline std::string PYTHON_ESCAPE_CHAR = "\\\\";
 inline const char *JSON_CHARS = "{}";
@@ -78,11 +90,16 @@ inline const std::array<int, 2> empty_idx{};
 //    inline std::vector<std::string> country_codes_lower =
 //    {"af","ax","al","dz","as","ad","ao","ai","aq","ag","ar","am","aw","au","at","az","bs","bh","bd","bb","by","be","bz","bj","bm","bt","bo","bq","ba","bw","bv","br","io","bn","bg","bf","bi","kh","cm","ca","cv","ky","cf","td","cl","cn","cx","cc","co","km","cg","cd","ck","cr","ci","hr","cu","cw","cy","cz","dk","dj","dm","do","ec","eg","sv","gq","er","ee","et","fk","fo","fj","fi","fr","gf","pf","tf","ga","gm","ge","de","gh","gi","gr","gl","gd","gp","gu","gt","gg","gn","gw","gy","ht","hm","va","hn","hk","hu","is","in","id","ir","iq","ie","im","il","it","jm","jp","je","jo","kz","ke","ki","kp","kr","kw","kg","la","lv","lb","ls","lr","ly","li","lt","lu","mo","mk","mg","mw","my","mv","ml","mt","mh","mq","mr","mu","yt","mx","fm","md","mc","mn","me","ms","ma","mz","mm","na","nr","np","nl","nc","nz","ni","ne","ng","nu","nf","mp","no","om","pk","pw","ps","pa","pg","py","pe","ph","pn","pl","pt","pr","qa","re","ro","ru","rw","bl","sh","kn","lc","mf","pm","vc","ws","sm","st","sa","sn","rs","sc","sl","sg","sx","sk","si","sb","so","za","gs","ss","es","lk","sd","sr","sj","sz","se","ch","sy","tw","tj","tz","th","tl","tg","tk","to","tt","tn","tr","tm","tc","tv","ug","ua","ae","gb","us","um","uy","uz","vu","ve","vn","vg","vi","wf","eh","ye","zm","zw","afg","alb","dza","asm","and","ago","aia","ata","atg","arg","arm","abw","aus","aut","aze","bhs","bhr","bgd","brb","blr","bel","blz","ben","bmu","btn","bol","bih","bwa","bvt","bra","iot","vgb","brn","bgr","bfa","bdi","khm","cmr","can","cpv","cym","caf","tcd","chl","chn","cxr","cck","col","com","cod","cog","cok","cri","civ","cub","cyp","cze","dnk","dji","dma","dom","ecu","egy","slv","gnq","eri","est","eth","fro","flk","fji","fin","fra","guf","pyf","atf","gab","gmb","geo","deu","gha","gib","grc","grl","grd","glp","gum","gtm","gin","gnb","guy","hti","hmd","vat","hnd","hkg","hrv","hun","isl","ind","idn","irn","irq","irl","isr","ita","jam","jpn","jor","kaz","ken","kir","prk","kor","kwt","kgz","lao","lva","lbn","lso","lbr","lby","lie","ltu","lux","mac","mkd","mdg","mwi","mys","mdv","mli","mlt","mhl","mtq","mrt","mus","myt","mex","fsm","mda","mco","mng","msr","mar","moz","mmr","nam","nru","npl","ant","nld","ncl","nzl","nic","ner","nga","niu","nfk","mnp","nor","omn","pak","plw","pse","pan","png","pry","per","phl","pcn","pol","prt","pri","qat","reu","rou","rus","rwa","shn","kna","lca","spm","vct","wsm","smr","stp","sau","sen","scg","syc","sle","sgp","svk","svn","slb","som","zaf","sgs","esp","lka","sdn","sur","sjm","swz","swe","che","syr","twn","tjk","tza","tha","tls","tgo","tkl","ton","tto","tun","tur","tkm","tca","tuv","vir","uga","ukr","are","gbr","umi","usa","ury","uzb","vut","ven","vnm","wlf","esh","yem","zmb","zwe"};;
 
-py::object eval_type(std::string value);
+ValueKind classify_value(const std::string_view &value);
+bool parse_uint64(const std::string_view &digits,
+                  std::uint64_t *result) noexcept;
+bool parse_double(const std::string_view &value, double *result);
+py::object eval_type(std::string value, bool recursive = false);
 py::object eval_datetime(const std::string &value);
 std::map<std::string, py::object> eval_csv(
     const std::string &input, const char *extra_disallowed_header_chars);
 bool is_nan(std::string value);
+bool is_quoted(const char &first_char, const char &last_char);
 
 std::map<std::string, std::vector<std::string>> convert_to_map_str(
     const py::object &dictionary);
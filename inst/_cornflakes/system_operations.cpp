@@ -2,6 +2,24 @@
 
 #include <system_operations.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <sys/mman.h>
+#include <unistd.h>
+extern char **environ;
+#else
+#define environ _environ
+#endif
+
 //! implementations for system operations
 namespace system_operations {
 
@@ -28,6 +46,74 @@ bool file_exists(const std::string &path) {
   return (buffer.st_mode & S_IFREG);
 }
 
+/**
+ * Identity of a file (path, modification time, size, inode and device).
+ * @param path path to the file.
+ * @param[out] result identity of the file.
+ * @return true if the file exists, false otherwise.
+ */
+bool file_stat(const std::string &path, FileStat *result) {
+  struct stat buffer {};
+  if (stat(path.c_str(), &buffer) != 0) return (false);
+  result->path = path;
+#if defined(__APPLE__)
+  result->mtime_ns =
+      static_cast<std::int64_t>(buffer.st_mtimespec.tv_sec) * 1000000000 +
+      buffer.st_mtimespec.tv_nsec;
+#elif defined(_WIN32)
+  result->mtime_ns = static_cast<std::int64_t>(buffer.st_mtime) * 1000000000;
+#else
+  result->mtime_ns =
+      static_cast<std::int64_t>(buffer.st_mtim.tv_sec) * 1000000000 +
+      buffer.st_mtim.tv_nsec;
+#endif
+  result->size = static_cast<std::uint64_t>(buffer.st_size);
+  result->inode = static_cast<std::uint64_t>(buffer.st_ino);
+  result->device = static_cast<std::uint64_t>(buffer.st_dev);
+  result->is_regular = buffer.st_mode & S_IFREG;
+  return (true);
+}
+
+/**
+ * Copy of all environment variables (one scan of environ), later lookups are
+ * hash lookups and never see changes of the environment.
+ */
+Environment::Environment() {
+  for (char **variable = environ; variable && *variable; ++variable) {
+    const std::string_view entry(*variable);
+    const std::size_t value_idx = entry.find('=');
+    if (value_idx == std::string_view::npos || !value_idx) continue;
+    values.emplace(entry.substr(0, value_idx), entry.substr(value_idx + 1));
+  }
+  // case-insensitive index (first variable in environ order wins)
+  for (char **variable = environ; variable && *variable; ++variable) {
+    const std::string_view entry(*variable);
+    const std::size_t value_idx = entry.find('=');
+    if (value_idx == std::string_view::npos || !value_idx) continue;
+    std::string name(entry.substr(0, value_idx));
+    const auto value_iter = values.find(name);
+    std::transform(name.begin(), name.end(), name.begin(), ::toupper);
+    upper_values.emplace(std::move(name), &value_iter->second);
+  }
+}
+
+/**
+ * Lookup of an environment variable: exact name, upper case name and finally
+ * any variable with the same name ignoring the case.
+ * @param name name of the variable.
+ * @param upper_name upper case name of the variable.
+ * @return value of the variable or nullptr if not set.
+ */
+const std::string *Environment::find(const std::string &name,
+                                     const std::string &upper_name) const {
+  auto value_iter = values.find(name);
+  if (value_iter != values.end()) return &value_iter->second;
+  value_iter = values.find(upper_name);
+  if (value_iter != values.end()) return &value_iter->second;
+  const auto upper_iter = upper_values.find(upper_name);
+  return upper_iter == upper_values.end() ? nullptr : upper_iter->second;
+}
+
 /**
  * Portable wrapper for mkdir. Internally used by make_directory()
  * @param[in] path the full path of the directory to create.
@@ -82,6 +168,100 @@ std::string path_exanduser(std::string value) {
   return value;
 }
 
+/**
+ * Checks if a path contains glob characters (*, ? or [)
+ * @param path path to check.
+ * @return true if the path is a glob pattern.
+ */
+bool is_pattern(const std::string &path) {
+  return path.find_first_of(GLOB_CHARS) != std::string::npos;
+}
+
+#ifndef _WIN32
+inline std::string join_path(const std::string &dir, const std::string &name) {
+  if (dir.empty()) return name;
+  return dir.back() == FILE_SEPERATOR ? dir + name
+                                      : dir + FILE_SEPERATOR + name;
+}
+
+// entries of a directory (without . and ..)
+inline std::vector<std::string> list_dir(const std::string &dir) {
+  std::vector<std::string> names;
+  DIR *handle = opendir(dir.empty() ? "." : dir.c_str());
+  if (handle == nullptr) return names;
+  while (const dirent *entry = readdir(handle)) {
+    const std::string name = entry->d_name;
+    if (name != "." && name != "..") names.push_back(name);
+  }
+  closedir(handle);
+  return names;
+}
+
+// match the path components from idx on ("**" -> any number of directories)
+void glob_walk(const std::string &dir, const std::vector<std::string> &parts,
+               std::size_t idx, std::vector<std::string> *result) {
+  if (idx == parts.size()) {
+    if (file_exists(dir)) result->push_back(dir);
+    return;
+  }
+  const std::string &part = parts[idx];
+  if (!is_pattern(part)) {
+    glob_walk(join_path(dir, part), parts, idx + 1, result);
+    return;
+  }
+  if (part == RECURSIVE_PATTERN) {
+    glob_walk(dir, parts, idx + 1, result);
+    for (const auto &name : list_dir(dir)) {
+      const std::string path = join_path(dir, name);
+      if (name[0] != '.' && dir_exists(path)) {
+        glob_walk(path, parts, idx, result);
+      }
+    }
+    return;
+  }
+  for (const auto &name : list_dir(dir)) {
+    if (fnmatch(part.c_str(), name.c_str(), FNM_PERIOD) == 0) {
+      glob_walk(join_path(dir, name), parts, idx + 1, result);
+    }
+  }
+}
+#endif
+
+/**
+ * Expands a directory (ini files inside) or a glob pattern (*, ?, [...] and **
+ * for any number of directories) into the matching files (sorted). Existing
+ * files (even with pattern characters in their name), other paths and all
+ * paths on windows are returned unchanged.
+ * @param path file, directory or glob pattern.
+ * @return matching paths.
+ */
+std::vector<std::string> expand_path(const std::string &path) {
+#ifndef _WIN32
+  if (file_exists(path)) return {path};
+  if (!is_pattern(path) && !dir_exists(path)) return {path};
+  const std::string pattern =
+      is_pattern(path) ? path : join_path(path, DIR_PATTERN);
+
+  std::vector<std::string> parts;
+  std::size_t begin = 0;
+  while (begin <= pattern.size()) {
+    const std::size_t end =
+        std::min(pattern.find(FILE_SEPERATOR, begin), pattern.size());
+    if (end > begin) parts.push_back(pattern.substr(begin, end - begin));
+    begin = end + 1;
+  }
+
+  std::vector<std::string> result;
+  glob_walk(pattern[0] == FILE_SEPERATOR ? std::string(1, FILE_SEPERATOR) : "",
+            parts, 0, &result);
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+  return result;
+#else
+  return {path};
+#endif
+}
+
 std::string read_file(const std::string &file) {
   try {
     std::ifstream in(file);
@@ -106,4 +286,120 @@ std::string read_file(const std::string &file) {
   }
 }
 
+FileBuffer::FileBuffer(std::string t_buffer)
+    : buffer(std::move(t_buffer)), contents(buffer) {}
+
+FileBuffer::~FileBuffer() {
+#ifndef _WIN32
+  if (mapping != nullptr) munmap(mapping, mapping_size);
+#endif
+}
+
+/**
+ * Read-only view of a file without copying its contents. Regular files are
+ * memory-mapped, everything else (pipes, procfs, small files, windows) falls
+ * back to a buffered read.
+ * A mapping raises SIGBUS once the file is truncated in place, so buffers
+ * that outlive the call must be owned: ini_load reads config files (of any
+ * size) into owned buffers for the file cache and the value trees, only
+ * transient reads (images, source hashes) are mapped.
+ * @param file path of the file to read.
+ * @param owned read into an owned buffer (never mapped).
+ * @return shared file buffer, valid as long as a reference exists.
+ */
+std::shared_ptr<const FileBuffer> map_file(const std::string &file,
+                                           bool owned) {
+#ifdef _WIN32
+  static_cast<void>(owned);  // never mapped
+  return std::make_shared<const FileBuffer>(read_file(file));
+#else
+  const int fd = open(file.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error(file + " not a valid file! " +
+                             "Check the path and permissions.");
+  }
+  struct stat buffer {};
+  const bool is_regular = fstat(fd, &buffer) == 0 && S_ISREG(buffer.st_mode);
+  auto result = std::make_shared<FileBuffer>();
+
+  if (!owned && is_regular &&
+      static_cast<std::size_t>(buffer.st_size) >= MMAP_MIN_SIZE) {
+    void *mapping = mmap(nullptr, static_cast<std::size_t>(buffer.st_size),
+                         PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping != MAP_FAILED) {
+#ifdef MADV_SEQUENTIAL
+      madvise(mapping, static_cast<std::size_t>(buffer.st_size),
+              MADV_SEQUENTIAL);
+#endif
+      close(fd);
+      result->mapping = mapping;
+      result->mapping_size = static_cast<std::size_t>(buffer.st_size);
+      result->contents = std::string_view(static_cast<const char *>(mapping),
+                                          result->mapping_size);
+      return result;
+    }
+  }
+
+  // buffered read (st_size is 0 or wrong for pipes and procfs)
+  std::size_t size = 0;
+  result->buffer.resize(is_regular && buffer.st_size > 0
+                            ? static_cast<std::size_t>(buffer.st_size)
+                            : MMAP_MIN_SIZE);
+  while (true) {
+    if (size == result->buffer.size()) result->buffer.resize(size * 2);
+    const ssize_t count =
+        read(fd, &result->buffer[size], result->buffer.size() - size);
+    if (count < 0) {
+      close(fd);
+      throw std::runtime_error(file + " could not be read!");
+    }
+    if (count == 0) break;
+    size += static_cast<std::size_t>(count);
+  }
+  close(fd);
+  result->buffer.resize(size);
+  result->contents = result->buffer;
+  return result;
+#endif
+}
+
+/**
+ * Run function(0) ... function(count - 1) on a small set of worker threads
+ * (threads are started per call, so there is nothing to break on fork).
+ * @param count number of work items.
+ * @param function work item, must not touch python objects.
+ * @throws the first exception of a work item (after all workers finished).
+ */
+void parallel_for(std::size_t count,
+                  const std::function<void(std::size_t)> &function) {
+  const std::size_t workers =
+      std::min({count, MAX_THREADS,
+                std::max<std::size_t>(std::thread::hardware_concurrency(), 1)});
+  if (workers <= 1) {
+    for (std::size_t idx = 0; idx < count; ++idx) function(idx);
+    return;
+  }
+
+  std::atomic<std::size_t> next_idx{0};
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  auto worker = [&]() {
+    for (std::size_t idx = next_idx++; idx < count; idx = next_idx++) {
+      try {
+        function(idx);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) error = std::current_exception();
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(workers - 1);
+  for (std::size_t idx = 1; idx < workers; ++idx) threads.emplace_back(worker);
+  worker();  // calling thread takes part
+  for (auto &thread : threads) thread.join();
+  if (error) std::rethrow_exception(error);
+}
+
 }  // namespace system_operations
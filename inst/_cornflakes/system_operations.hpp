@@ -6,11 +6,17 @@
 #include <sys/stat.h>
 
 #include <algorithm>
+#include <cstdint>
 #include <cstring>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 namespace system_operations {  // cppcheck-suppress syntaxError
 
@@ -33,12 +39,80 @@ inline const char FILE_SEPERATOR = '/';  // Mac OS X uses \n
 #endif
 
 inline const char NEWLINE = LINE_SEPERATOR[std::strlen(LINE_SEPERATOR) - 1];
+// smaller files are read into a buffer (mmap setup costs more than a copy)
+inline const std::size_t MMAP_MIN_SIZE = 1 << 16;
+// upper bound of worker threads for parallel_for
+inline const std::size_t MAX_THREADS = 8;
+// glob patterns of expand_path
+inline const char *GLOB_CHARS = "*?[";
+inline const std::string RECURSIVE_PATTERN = "**";
+inline const std::string DIR_PATTERN = "*.ini";  // files of a directory
+
+// Read-only file contents (memory-mapped or buffered)
+class FileBuffer {
+ public:
+  FileBuffer() = default;
+  explicit FileBuffer(std::string t_buffer);
+  FileBuffer(const FileBuffer &) = delete;
+  FileBuffer &operator=(const FileBuffer &) = delete;
+  ~FileBuffer();
+  std::string_view view() const { return contents; }
+  bool is_mapped() const { return mapping != nullptr; }
+  friend std::shared_ptr<const FileBuffer> map_file(const std::string &file,
+                                                    bool owned);
+
+ private:
+  std::string buffer;            // fallback (pipes, procfs, windows)
+  void *mapping = nullptr;       // memory mapped file
+  std::size_t mapping_size = 0;  // size of the mapping
+  std::string_view contents;     // view into buffer or mapping
+};
+
+// File identity (changes whenever the file is replaced or modified)
+struct FileStat {
+  std::string path;
+  std::int64_t mtime_ns = 0;
+  std::uint64_t size = 0;
+  std::uint64_t inode = 0;
+  std::uint64_t device = 0;
+  bool is_regular = false;
+  bool operator==(const FileStat &other) const {
+    return mtime_ns == other.mtime_ns && size == other.size &&
+           inode == other.inode && device == other.device &&
+           path == other.path;
+  }
+  bool operator!=(const FileStat &other) const { return !(*this == other); }
+};
+
+// Indexed snapshot of the process environment (read-only, thread safe)
+class Environment {
+ public:
+  Environment();
+  Environment(const Environment &) = delete;
+  Environment &operator=(const Environment &) = delete;
+  const std::string *find(const std::string &name,
+                          const std::string &upper_name) const;
+  std::size_t size() const { return values.size(); }
+
+ private:
+  std::unordered_map<std::string, std::string> values;
+  // upper case name -> first variable with this name (case-insensitive)
+  std::unordered_map<std::string, const std::string *> upper_values;
+};
+
 bool exists(const std::string &path);
 bool dir_exists(const std::string &path);
 bool file_exists(const std::string &path);
 int make_directory(const char *path);
 std::string path_exanduser(std::string value);
+bool is_pattern(const std::string &path);
+std::vector<std::string> expand_path(const std::string &path);
 std::string read_file(const std::string &file);
+std::shared_ptr<const FileBuffer> map_file(const std::string &file,
+                                           bool owned = false);
+bool file_stat(const std::string &path, FileStat *result);
+void parallel_for(std::size_t count,
+                  const std::function<void(std::size_t)> &function);
 
 }  // namespace system_operations
 
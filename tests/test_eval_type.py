@@ -1,3 +1,4 @@
+from array import array
 from datetime import datetime, timedelta, timezone
 from ipaddress import ip_address
 import sys
@@ -25,12 +26,29 @@ class TestEvalType(unittest.TestCase):
 
     def test_dot(self):
         self.assertEqual(cornflakes.eval_type("'.'"), ".")
+        [self.assertEqual(cornflakes.eval_type(x), x) for x in [".", "1.2.", "-.", "1e"]]
+
+    def test_bool(self):
+        [self.assertEqual(cornflakes.eval_type(x), True) for x in ["true", "True", "TRUE"]]
+        [self.assertEqual(cornflakes.eval_type(x), False) for x in ["false", "False", "FALSE"]]
+        [self.assertEqual(cornflakes.eval_type(x), x) for x in ["truee", "fals"]]
 
     def test_integer(self):
         [self.assertEqual(cornflakes.eval_type(str(x)), x) for x in [*range(10), sys.maxsize, -sys.maxsize]]
+        [
+            self.assertEqual(cornflakes.eval_type(str(x)), x)
+            for x in [12, -345, 2**63, -(2**63), 2**64, -(2**64), 10**18, 10**19 - 1, 10**19, 10**40, -(10**40)]
+        ]
+        self.assertEqual(cornflakes.eval_type("+5"), 5)
+        self.assertEqual(cornflakes.eval_type("007"), 7)
 
     def test_float(self):
         [self.assertEqual(cornflakes.eval_type(str(x)), x) for x in [0.1, 1.0, 0.0, -0.1, 0.00000000000000000012312301]]
+        [
+            self.assertEqual(cornflakes.eval_type(x), float(x))
+            for x in ["3.14159265358979", "-0.0", ".5", "5.", "1.5e-3"]
+        ]
+        self.assertEqual(cornflakes.eval_type("1.5xe-3"), "1.5xe-3")
 
     def test_ipv4(self):
         [self.assertEqual(cornflakes.eval_type(x), ip_address(x)) for x in ["1.1.1.1", "1:1:1:1:1:1:1:1"]]
@@ -161,6 +179,14 @@ class TestEvalType(unittest.TestCase):
             timezone(timedelta(-1, 77160)),
         )
 
+    def test_timestamp_timezones(self):
+        first = cornflakes.eval_type("2006-03-17T13:27:54+03:45")
+        second = cornflakes.eval_type("2007-04-18T14:28:55+03:45")
+        self.assertIs(first.tzinfo, second.tzinfo)
+        self.assertEqual(first.utcoffset(), timedelta(hours=3, minutes=45))
+        self.assertIs(cornflakes.eval_type("2006-03-17T13:27:54Z").tzinfo, timezone.utc)
+        self.assertEqual(cornflakes.eval_type("2006-03-17T13:27:54-05:37").utcoffset(), -timedelta(hours=5, minutes=37))
+
     def test_wrong_timestamp_values(self):
         self.assertEqual(
             cornflakes.eval_type("2017-01-01 24:23:23"),
@@ -185,3 +211,60 @@ class TestEvalType(unittest.TestCase):
 
     def test_json(self):
         [self.assertEqual(cornflakes.eval_type(x), eval(x)) for x in ['{"test": 1}', "[1, 2, 3]"]]
+        self.assertEqual(
+            cornflakes.eval_type('{"a": true, "b": null, "c": [1.5, -2, "x"]}'),
+            {"a": True, "b": None, "c": [1.5, -2, "x"]},
+        )
+        self.assertEqual(
+            cornflakes.eval_type("['a', {'b': 2e3, 'c': 10000000000000000000001}]"),
+            ["a", {"b": 2e3, "c": 10**22 + 1}],
+        )
+        self.assertEqual(cornflakes.eval_type('["a\\nb"]'), ["a\\nb"])
+        self.assertEqual(cornflakes.eval_type("[1, 2"), "[1, 2")
+
+    def test_json_recursive(self):
+        value = '{"port": "8080", "ip": "1.1.1.1", "nested": ["0xFF", "true", "text"]}'
+        self.assertEqual(cornflakes.eval_type(value)["port"], "8080")
+        self.assertEqual(
+            cornflakes.eval_type(value, recursive=True),
+            {"port": 8080, "ip": ip_address("1.1.1.1"), "nested": [255, True, "text"]},
+        )
+
+    def test_samples(self):
+        """One sample per type of the eval_type benchmark."""
+        self.assertEqual(cornflakes.eval_type("123456"), 123456)
+        self.assertEqual(cornflakes.eval_type("1234.5678"), 1234.5678)
+        self.assertEqual(cornflakes.eval_type("0x1F"), 31)
+        self.assertIs(cornflakes.eval_type("false"), False)
+        self.assertEqual(cornflakes.eval_type("value"), "value")
+
+    def test_batch(self):
+        values = ["1", "-12", "1.5", "true", "FALSE", "", None, "''", "value", "0xFF", "2006-03-17 13:27:54", "[1, 2]"]
+        result, codes = cornflakes.eval_type_batch(values)
+        self.assertEqual(result, [cornflakes.eval_type(x or "") for x in values])
+        self.assertEqual(list(codes), [2, 2, 3, 1, 1, 0, 0, 0, 4, 2, 5, 5])
+        self.assertEqual(cornflakes.eval_type_batch(("a", "2")), (["a", 2], b"\x04\x02"))
+        self.assertEqual(cornflakes.eval_type_batch([]), ([], b""))
+        with self.assertRaises(TypeError):
+            cornflakes.eval_type_batch(["1", 2])
+
+    def test_batch_mixed(self):
+        """Mixed values of the eval_type_batch benchmark."""
+        values = ["123456", "1234.5678", "true", "value", "", "2006-03-17 13:27:54"] * 100
+        result, _ = cornflakes.eval_type_batch(values)
+        self.assertEqual(result, [cornflakes.eval_type(value) for value in values])
+
+    def test_batch_buffers(self):
+        values = ["1", "", "1.5", "value", "123e4567-e89b-12d3-a456-426655440000"]
+        data = "".join(values).encode()
+        for typecode in ["i", "q"]:
+            offsets = array(typecode, [0])
+            for value in values:
+                offsets.append(offsets[-1] + len(value))
+            result, codes = cornflakes.eval_type_batch(offsets, data)
+            self.assertEqual(result, [1, None, 1.5, "value", UUID(values[-1])])
+            self.assertEqual(list(codes), [2, 0, 3, 4, 5])
+        with self.assertRaises(ValueError):
+            cornflakes.eval_type_batch(array("i", [0, 100]), data)
+        with self.assertRaises(ValueError):
+            cornflakes.eval_type_batch(array("d", [0, 1]), data)
@@ -1,7 +1,16 @@
+import datetime
+import decimal
+import ipaddress
 import os
+import sys
+import tempfile
+from typing import Optional
 import unittest
+import uuid
 
+import _cornflakes
 import cornflakes
+from cornflakes.common import type_to_str
 
 
 class TestIniLoad(unittest.TestCase):
@@ -357,3 +366,557 @@ class TestIniLoad(unittest.TestCase):
         self.assertEqual(
             cornflakes.ini_load({None: None}, None, keys={"blub": "bla"}, eval_env=True), {None: {"blub": 123}}
         )
+
+    def test_ini_load_cache(self):
+        cornflakes.ini_cache_clear()
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            file = os.path.join(tmp_dir, "cached.ini")
+            with open(file, "w") as f:
+                f.write("[section]\nkey = 1\nother = [1, 2]\n")
+
+            self.assertEqual(cornflakes.ini_load(file), {"section": {"key": 1, "other": [1, 2]}})
+            result = cornflakes.ini_load(file, keys={"other": "other"})
+            self.assertEqual(result, {"section": {"other": [1, 2]}})
+            result["section"]["other"].append(3)  # cached values are not shared
+            self.assertEqual(cornflakes.ini_load(file, keys={"other": "other"}), {"section": {"other": [1, 2]}})
+            self.assertEqual(cornflakes.ini_cache_info()["misses"], 1)
+            self.assertEqual(cornflakes.ini_cache_info()["hits"], 2)
+            self.assertEqual(cornflakes.ini_cache_info()["size"], 1)
+
+            with open(file, "w") as f:
+                f.write("[section]\nkey = 22\n")
+            self.assertEqual(cornflakes.ini_load(file), {"section": {"key": 22}})
+            self.assertEqual(cornflakes.ini_cache_info()["misses"], 2)
+            self.assertEqual(cornflakes.ini_cache_info()["evictions"], 1)
+
+        cornflakes.ini_cache_clear()
+        self.assertEqual(cornflakes.ini_cache_info()["size"], 0)
+
+    def test_ini_load_cache_same_stat(self):
+        """A rewrite with the same size and mtime is not hidden by the cache."""
+        cornflakes.ini_cache_clear()
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            file = os.path.join(tmp_dir, "cached.ini")
+            with open(file, "w") as f:
+                f.write("[section]\nkey = 1\n")
+            stat = os.stat(file)
+            self.assertEqual(cornflakes.ini_load(file), {"section": {"key": 1}})
+            self.assertEqual(cornflakes.ini_load(file), {"section": {"key": 1}})
+
+            with open(file, "w") as f:
+                f.write("[section]\nkey = 2\n")
+            os.utime(file, ns=(stat.st_atime_ns, stat.st_mtime_ns))
+            self.assertEqual(os.stat(file).st_size, stat.st_size)
+            self.assertEqual(cornflakes.ini_load(file), {"section": {"key": 2}})
+            self.assertEqual(cornflakes.ini_load(file), {"section": {"key": 2}})
+        cornflakes.ini_cache_clear()
+
+    def test_ini_load_truncated_file(self):
+        """Cached files (larger than the mmap threshold) survive in-place truncation."""
+        cornflakes.ini_cache_clear()
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            file = os.path.join(tmp_dir, "large.ini")
+            with open(file, "w") as f:
+                f.write("[section]\n" + "".join(f"key_{idx} = {idx}\n" for idx in range(8192)))
+            self.assertEqual(cornflakes.ini_load(file)["section"]["key_8191"], 8191)
+
+            with open(file, "r+") as f:
+                f.truncate(0)
+            self.assertEqual(cornflakes.ini_load(file), {})
+            with open(file, "w") as f:
+                f.write("[section]\nkey_0 = 1\n")
+            self.assertEqual(cornflakes.ini_load(file), {"section": {"key_0": 1}})
+        cornflakes.ini_cache_clear()
+
+    def test_ini_load_source_removed(self):
+        """Loaded values and cached files do not depend on the source file."""
+        cornflakes.ini_cache_clear()
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            file = os.path.join(tmp_dir, "removed.ini")
+            with open(file, "w") as f:
+                f.write("[db]\nhost = localhost\nport = 5432\n[cache]\n")
+                f.write("".join(f"key_{idx} = value_{idx}\n" for idx in range(5000)))
+            parser = cornflakes.IniParser({None: [file]}, keys=["host", "port"])
+            result, selected = cornflakes.ini_load(file), parser.load()
+            expected = {"db": {"host": "localhost", "port": 5432}, "cache": {}}
+            self.assertEqual(selected, expected)
+
+            os.remove(file)
+            self.assertEqual(result["db"], {"host": "localhost", "port": 5432})
+            self.assertEqual(result["cache"]["key_4999"], "value_4999")
+            self.assertEqual(selected, expected)
+
+            # rewritten at the same path -> new values, previous results unchanged
+            with open(file, "w") as f:
+                f.write("[db]\nhost = remote\n")
+            self.assertEqual(cornflakes.ini_load(file), {"db": {"host": "remote"}})
+            self.assertEqual(parser.load(), {"db": {"host": "remote"}})
+            self.assertEqual(result["db"], {"host": "localhost", "port": 5432})
+            self.assertEqual(len(result["cache"]), 5000)
+            self.assertEqual(selected, expected)
+        cornflakes.ini_cache_clear()
+
+    def test_ini_load_layered_files(self):
+        """Files are read in parallel but merged in the given order."""
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            files = []
+            for idx in range(24):
+                files.append(os.path.join(tmp_dir, f"layer_{idx}.ini"))
+                with open(files[-1], "w") as f:
+                    f.write(f"[default]\nlayer = {idx}\nlayer_{idx} = {idx}\n")
+
+            result = cornflakes.ini_load({None: files})
+            self.assertEqual(result["default"]["layer"], 23)
+            self.assertEqual(len(result["default"]), 25)
+            self.assertEqual(cornflakes.ini_load({None: files[::-1]})["default"]["layer"], 0)
+
+    def test_ini_load_value_types(self):
+        """Natively typed values match eval_type."""
+        values = [
+            "1",
+            "-12",
+            "+7",
+            "123456789012345678",
+            "1234567890123456789",
+            "0.5",
+            "-1.",
+            ".25",
+            "1.2e-5",
+            "true",
+            "False",
+            "none",
+            "'quoted'",
+            '"3"',
+            "'x'",
+            "abc",
+            "abcdef",
+            "some longer plain string value that is not a date",
+            "1.1.1.1",
+            "2006-03-17 13:27:54",
+            "0xFF",
+            "[1, 2, 3]",
+            '{"a": 1}',
+        ]
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            file = os.path.join(tmp_dir, "types.ini")
+            with open(file, "w") as f:
+                f.write("[types]\n" + "".join(f"key_{idx} = {value}\n" for idx, value in enumerate(values)))
+
+            result = cornflakes.ini_load(file)["types"]
+            for idx, value in enumerate(values):
+                self.assertEqual(result[f"key_{idx}"], cornflakes.eval_type(value), value)
+                self.assertEqual(type(result[f"key_{idx}"]), type(cornflakes.eval_type(value)), value)
+
+    def test_ini_load_selection(self):
+        keys = {
+            "aws_access_key_id": ["access_key", "aws_access_key_id"],
+            "endpoint_url": ["endpoint-url", "host_base"],
+            "region_name": ["bucket_location", "region", "aws_default_region"],
+        }
+        files = {"s3_configs": ["tests/configs/.s3cfg", "tests/configs/aws_config"]}
+        sections = ["qa", "prod", "default"]
+        selection = cornflakes.IniSelection(sections=sections, keys=keys)
+
+        expected = cornflakes.ini_load(files, sections, keys)
+        for _ in range(3):
+            self.assertEqual(cornflakes.ini_load(files, selection=selection), expected)
+        # arguments take precedence over the compiled selection
+        self.assertEqual(
+            cornflakes.ini_load(files, sections=["default"], selection=selection),
+            cornflakes.ini_load(files, ["default"], keys),
+        )
+        self.assertEqual(
+            cornflakes.ini_load(files, selection=cornflakes.IniSelection(keys=keys)),
+            cornflakes.ini_load(files, keys=keys),
+        )
+
+    def test_ini_load_environment(self):
+        os.environ["CF_SNAPSHOT_VALUE"] = "1"
+        os.environ["Cf_Mixed_Case"] = "mixed"
+        keys = {"value": "cf_snapshot_value", "mixed": "cf_mixed_case"}
+        environment = cornflakes.Environment()
+        self.assertGreater(len(environment), 0)
+
+        self.assertEqual(
+            cornflakes.ini_load({None: None}, {None: None}, keys=keys, eval_env=True),
+            {"value": 1, "mixed": "mixed"},
+        )
+        # the long-lived snapshot does not see later changes
+        os.environ["CF_SNAPSHOT_VALUE"] = "2"
+        self.assertEqual(
+            cornflakes.ini_load({None: None}, {None: None}, keys=keys, eval_env=True, environment=environment),
+            {"value": 1, "mixed": "mixed"},
+        )
+        self.assertEqual(
+            cornflakes.ini_load({None: None}, {None: None}, keys=keys, eval_env=True), {"value": 2, "mixed": "mixed"}
+        )
+        self.assertEqual(cornflakes.ini_load({None: None}, {None: None}, keys=keys, environment=environment), {})
+
+    def test_ini_parser(self):
+        files = {None: ["tests/configs/default.ini", "tests/configs/some_config"]}
+        parser = cornflakes.IniParser(files)
+        expected = cornflakes.ini_load(files)
+        self.assertEqual(parser.load(), expected)
+        result = parser.load()
+        self.assertEqual(result, expected)
+        result.clear()
+        self.assertEqual(parser.load(), expected)
+        self.assertEqual(parser.load(stats=True)[0], expected)
+
+    def test_ini_load_shared_names(self):
+        with tempfile.NamedTemporaryFile("w", suffix=".ini", delete=False) as f:
+            f.write("[db]\nhost = a\nport = 1\n[cache]\nhost = b\nport = 2\n[db]\ntimeout = 3\n")
+        try:
+            result = cornflakes.ini_load({None: [f.name]})
+            self.assertEqual(result, {"db": {"host": "a", "port": 1, "timeout": 3}, "cache": {"host": "b", "port": 2}})
+            db_keys, cache_keys = list(result["db"]), list(result["cache"])
+            self.assertIs(db_keys[0], cache_keys[0])
+            self.assertIs(db_keys[1], cache_keys[1])
+        finally:
+            os.remove(f.name)
+
+    def test_ini_reloader(self):
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            base, local = os.path.join(tmp_dir, "base.ini"), os.path.join(tmp_dir, "local.ini")
+            with open(base, "w") as f:
+                f.write("[db]\nhost = localhost\nport = 5432\n[cache]\nsize = 10\n")
+            with open(local, "w") as f:
+                f.write("[db]\nport = 5433\n")
+
+            reloader = cornflakes.IniReloader({None: [base, local]})
+            self.assertEqual(reloader.result, cornflakes.ini_load({None: [base, local]}))
+            self.assertEqual(reloader.reload(), [])
+
+            # same contents (new mtime) -> nothing changes
+            with open(local, "w") as f:
+                f.write("[db]\nport = 5433\n")
+            self.assertEqual(reloader.reload(), [])
+
+            with open(local, "w") as f:
+                f.write("[db]\nport = 5434\nuser = admin\n[queue]\nname = jobs\n")
+            self.assertEqual(sorted(reloader.reload(), key=str), [("db", "port"), ("db", "user"), ("queue",)])
+            self.assertEqual(reloader.result, cornflakes.ini_load({None: [base, local]}))
+
+            # same size and mtime (within the mtime granularity) -> still reloaded
+            stat = os.stat(local)
+            with open(local, "w") as f:
+                f.write("[db]\nport = 5435\nuser = admin\n[queue]\nname = jobs\n")
+            os.utime(local, ns=(stat.st_atime_ns, stat.st_mtime_ns))
+            self.assertEqual(reloader.reload(), [("db", "port")])
+            self.assertEqual(reloader.result["db"]["port"], 5435)
+
+            os.remove(local)
+            self.assertEqual(sorted(reloader.reload(), key=str), [("db", "port"), ("db", "user"), ("queue",)])
+            self.assertEqual(reloader.result["db"], {"host": "localhost", "port": 5432})
+
+    def test_ini_scanner(self):
+        """The vectorized scanners (SSE2 / AVX2) find the same structural characters as the scalar one."""
+        contents = [
+            b"",
+            b"=",
+            b"\n" * 130,
+            b"a" * 15 + b"=" + b"b" * 15 + b"#" + b"c" * 31 + b"\n" + b"d" * 63 + b"=",
+            b"".join(b" " * pad + b"key = 'v#1' # c\r\n" for pad in range(70)),
+            bytes(range(256)) * 3,
+        ]
+        scanners = []
+        for scanner in ["auto", "sse2", "avx2"]:
+            try:
+                _cornflakes._ini_scan(b"", scanner)
+                scanners.append(scanner)
+            except ValueError:  # not supported by this platform
+                pass
+        for value in contents:
+            expected = [idx for idx, char in enumerate(value) if char in b"\n#="]
+            self.assertEqual(_cornflakes._ini_scan(value, "scalar"), expected)
+            for scanner in scanners:
+                self.assertEqual(_cornflakes._ini_scan(value, scanner), expected, scanner)
+        with self.assertRaises(ValueError):
+            _cornflakes._ini_scan(b"", "neon")
+
+    def test_ini_load_block_boundaries(self):
+        """Structural characters and quotes on 16 / 32 / 64 byte boundaries (LF and CRLF)."""
+        body = "[section]\nkey = 'quoted = value'\nother = \"x\" # comment\nlast=3\n"
+        expected = {"section": {"key": "quoted = value", "other": "x", "last": 3}}
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            file = os.path.join(tmp_dir, "boundaries.ini")
+            for newline in ["\n", "\r\n"]:
+                results = []
+                for pad in range(80):
+                    # the padding shifts every character of the body by one byte
+                    with open(file, "w", newline="") as f:
+                        f.write(("#" + "p" * pad + "\n" + body).replace("\n", newline))
+                    results.append(cornflakes.ini_load(file))
+                if newline == "\n":
+                    self.assertEqual(results[0], expected)
+                for pad, result in enumerate(results):
+                    self.assertEqual(result, results[0], f"padding {pad} ({newline!r})")
+
+    def test_ini_stream(self):
+        with tempfile.NamedTemporaryFile("w", suffix=".ini", delete=False) as f:
+            f.write("# header\n[db]\nhost = localhost\nport = 5432\n[cache]\nsize = 10 # comment\n[db]\nport = 5433\n")
+        try:
+            # a small chunk size splits sections / lines between reads
+            stream = cornflakes.IniStream(f.name, chunk_size=7)
+            self.assertEqual(
+                list(stream),
+                [("db", {"host": "localhost", "port": 5432}), ("cache", {"size": 10}), ("db", {"port": 5433})],
+            )
+            self.assertEqual(stream.offset, os.path.getsize(f.name))
+            self.assertEqual(
+                list(cornflakes.IniStream(f.name, sections=["db"], keys=["port"])),
+                [("db", {"port": 5432}), ("db", {"port": 5433})],
+            )
+        finally:
+            os.remove(f.name)
+
+    def test_ini_load_image(self):
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            config, image = os.path.join(tmp_dir, "config.ini"), os.path.join(tmp_dir, "config.img")
+            with open(config, "w") as f:
+                f.write("[db]\nhost = localhost\nport = 5432\ncreated = 2022-01-01 10:00:00\nratio = 0.5\n")
+
+            expected = cornflakes.ini_load({None: [config]})
+            self.assertEqual(cornflakes.ini_load({None: [config]}, image=image), expected)
+            self.assertTrue(os.path.exists(image))
+            self.assertEqual(cornflakes.ini_load({None: [config]}, image=image), expected)
+
+            # stale image (changed source / other keys) -> parsed again
+            with open(config, "w") as f:
+                f.write("[db]\nhost = remote\n")
+            self.assertEqual(cornflakes.ini_load({None: [config]}, image=image), {"db": {"host": "remote"}})
+            self.assertEqual(cornflakes.ini_load({None: [config]}, keys=["port"], image=image), {"db": {}})
+
+    def test_ini_load_image_types(self):
+        """Typed values are stored natively, values without an encoding skip the image."""
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            config, image = os.path.join(tmp_dir, "config.ini"), os.path.join(tmp_dir, "config.img")
+            with open(config, "w") as f:
+                f.write("[types]\ncreated = 2022-01-01 10:00:00+02:00\nday = 2023-01-02\nat = 03:04:05.500000\n")
+                f.write("utc = 2023-01-02T03:04:05\nprice = 0.10\nid = 123e4567-e89b-12d3-a456-426614174000\n")
+                f.write("v4 = 10.0.0.1\nv6 = 2001:db8:85a3::8a2e:370:7334\nbig = 123456789012345678901234567890\n")
+                f.write("negative = -123456789012345678901234567890\nvalues = [1, 'a', 2.5]\n")
+            # outside the racy window -> the image is validated by stat
+            os.utime(config, (os.stat(config).st_atime - 10, os.stat(config).st_mtime - 10))
+            schema = {"day": datetime.date, "at": datetime.time, "utc": datetime.datetime, "price": decimal.Decimal}
+
+            expected = cornflakes.ini_load({None: [config]}, schema=schema)
+            self.assertEqual(cornflakes.ini_load({None: [config]}, schema=schema, image=image), expected)
+            self.assertTrue(os.path.exists(image))
+            result, stats = cornflakes.ini_load({None: [config]}, schema=schema, image=image, stats=True)
+            self.assertEqual(stats["files"], 0)  # read from the image
+            self.assertEqual(result, expected)
+            for key, value in expected["types"].items():
+                self.assertIs(type(result["types"][key]), type(value), key)
+            self.assertEqual(str(result["types"]["price"]), "0.10")
+            self.assertEqual(result["types"]["created"].utcoffset(), datetime.timedelta(hours=2))
+            self.assertEqual(result["types"]["utc"].utcoffset(), datetime.timedelta(0))
+
+            # timezone offset of seconds -> no encoding, no image
+            os.remove(image)
+            with open(config, "a") as f:
+                f.write("odd = 2023-01-02T03:04:05+00:00:30\n")
+            schema["odd"] = datetime.datetime
+            result = cornflakes.ini_load({None: [config]}, schema=schema, image=image)
+            self.assertEqual(result["types"]["odd"].utcoffset(), datetime.timedelta(seconds=30))
+            self.assertFalse(os.path.exists(image))
+
+    def test_ini_load_image_invalid(self):
+        """Malformed images are ignored."""
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            config, image = os.path.join(tmp_dir, "config.ini"), os.path.join(tmp_dir, "config.img")
+            with open(config, "w") as f:
+                f.write("[db]\nhost = localhost\n")
+            self.assertEqual(cornflakes.ini_load({None: [config]}, image=image), {"db": {"host": "localhost"}})
+            with open(image, "rb") as f:
+                contents = f.read()
+            for tampered in [contents[:-3], contents[:-1] + b"\xff", contents + b"\x00" * 8]:
+                with open(image, "wb") as f:
+                    f.write(tampered)
+                self.assertEqual(cornflakes.ini_load({None: [config]}, image=image), {"db": {"host": "localhost"}})
+
+    def test_ini_load_interpolate(self):
+        os.environ["CORNFLAKES_TEST_HOME"] = "/home/test"
+        with tempfile.NamedTemporaryFile("w", suffix=".ini", delete=False) as f:
+            f.write(
+                "base = /opt\n[paths]\nroot = ${base}/root\ndata = ${root}/data\nhome = ${CORNFLAKES_TEST_HOME}\n"
+                "port = ${db:port}\nliteral = $${root}\nmissing = ${missing}\n[db]\nport = 5432\n"
+            )
+        try:
+            self.assertEqual(
+                cornflakes.ini_load({None: [f.name]}, sections=["paths"], interpolate=True)["paths"],
+                {
+                    "root": "/opt/root",
+                    "data": "/opt/root/data",
+                    "home": "/home/test",
+                    "port": 5432,
+                    "literal": "${root}",
+                    "missing": "${missing}",
+                },
+            )
+            self.assertEqual(cornflakes.ini_load({None: [f.name]})["paths"]["root"], "${base}/root")
+
+            with open(f.name, "w") as cycle:
+                cycle.write("[cycle]\na = ${b}\nb = ${a}\n")
+            self.assertRaises(RuntimeError, cornflakes.ini_load, {None: [f.name]}, interpolate=True)
+        finally:
+            os.remove(f.name)
+            del os.environ["CORNFLAKES_TEST_HOME"]
+
+    def test_ini_load_multiline(self):
+        with tempfile.NamedTemporaryFile("w", suffix=".ini", delete=False) as f:
+            f.write(
+                "[tls]\ncert = -----BEGIN CERTIFICATE-----\n  MIIBa==\n  -----END CERTIFICATE-----\n\n"
+                "command = run \\\n  --verbose\nname = test\n"
+            )
+        try:
+            self.assertEqual(
+                cornflakes.ini_load({None: [f.name]}, multiline=True),
+                {
+                    "tls": {
+                        "cert": "-----BEGIN CERTIFICATE-----\nMIIBa==\n-----END CERTIFICATE-----",
+                        "command": "run --verbose",
+                        "name": "test",
+                    }
+                },
+            )
+            self.assertEqual(
+                cornflakes.ini_load({None: [f.name]}, keys=["cert"], multiline=True)["tls"]["cert"].splitlines()[1],
+                "MIIBa==",
+            )
+            self.assertEqual(cornflakes.ini_load({None: [f.name]})["tls"]["cert"], "-----BEGIN CERTIFICATE-----")
+        finally:
+            os.remove(f.name)
+
+    def test_ini_load_directory(self):
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            conf_dir = os.path.join(tmp_dir, "conf.d")
+            os.makedirs(os.path.join(conf_dir, "sub"))
+            for name, port in [("20-local.ini", 5433), ("10-base.ini", 5432), ("sub/30-extra.ini", 5434)]:
+                with open(os.path.join(conf_dir, name), "w") as f:
+                    f.write(f"[db]\nport = {port}\n[{name}]\nloaded = true\n")
+            with open(os.path.join(conf_dir, "notes.txt"), "w") as f:
+                f.write("[db]\nport = 1\n")
+
+            result = cornflakes.ini_load({None: [conf_dir]})
+            self.assertEqual(result["db"], {"port": 5433})
+            self.assertEqual(sorted(result), ["10-base.ini", "20-local.ini", "db"])
+            self.assertEqual(cornflakes.ini_load({None: [os.path.join(conf_dir, "**", "*.ini")]})["db"], {"port": 5434})
+            self.assertEqual(cornflakes.ini_load({None: [os.path.join(conf_dir, "1*.ini")]})["db"], {"port": 5432})
+
+    def test_ini_load_pattern_filename(self):
+        """Existing files are loaded literally, even with glob characters in their name."""
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            for name, port in [("conf[prod].ini", 5432), ("confp.ini", 5433)]:
+                with open(os.path.join(tmp_dir, name), "w") as f:
+                    f.write(f"[db]\nport = {port}\n")
+
+            literal, pattern = os.path.join(tmp_dir, "conf[prod].ini"), os.path.join(tmp_dir, "conf[dp].ini")
+            self.assertEqual(cornflakes.ini_load({None: [literal]})["db"], {"port": 5432})
+            self.assertEqual(cornflakes.ini_load({None: [pattern]})["db"], {"port": 5433})
+
+    def test_ini_load_schema(self):
+        with tempfile.NamedTemporaryFile("w", suffix=".ini", delete=False) as f:
+            f.write("[server]\nport = 0x1F90\nname = 123\nratio = 1e-3\ndebug = yes\nstarted = 2023-01-02T03:04:05\n")
+            f.write("day = 2023-01-02\nid = 123e4567-e89b-12d3-a456-426614174000\nhost = 10.0.0.1\nprice = 0.1\n")
+            f.write("untyped = 42\ntimeout = none\ncount = 1_000\n")
+        schema = {
+            "port": int,
+            "name": str,
+            "ratio": float,
+            "debug": bool,
+            "started": datetime.datetime,
+            "day": datetime.date,
+            "id": uuid.UUID,
+            "host": ipaddress.IPv4Address,
+            "price": decimal.Decimal,
+            "timeout": Optional[int],
+            "count": int,
+        }
+        try:
+            self.assertEqual(
+                cornflakes.ini_load({None: [f.name]}, schema=schema)["server"],
+                {
+                    "port": 8080,
+                    "name": "123",
+                    "ratio": 0.001,
+                    "debug": True,
+                    "started": datetime.datetime(2023, 1, 2, 3, 4, 5, tzinfo=datetime.timezone.utc),
+                    "day": datetime.date(2023, 1, 2),
+                    "id": uuid.UUID("123e4567-e89b-12d3-a456-426614174000"),
+                    "host": ipaddress.IPv4Address("10.0.0.1"),
+                    "price": decimal.Decimal("0.1"),
+                    "untyped": 42,
+                    "timeout": None,
+                    "count": 1000,
+                },
+            )
+            self.assertEqual(cornflakes.ini_load({None: [f.name]})["server"]["name"], 123)
+            self.assertRaises(ValueError, cornflakes.ini_load, {None: [f.name]}, schema={"host": int})
+            self.assertRaises(ValueError, cornflakes.ini_load, {None: [f.name]}, schema={"name": bool})
+        finally:
+            os.remove(f.name)
+
+    @unittest.skipIf(sys.version_info < (3, 10), "PEP 604 unions need python >= 3.10")
+    def test_ini_load_schema_union(self):
+        with tempfile.NamedTemporaryFile("w", suffix=".ini", delete=False) as f:
+            f.write("[server]\nport = 0x1F90\nname = 123\ntimeout = none\nid = 42\n")
+        try:
+            schema = {"port": int | None, "name": str | None, "timeout": int | None}
+            self.assertEqual(
+                cornflakes.ini_load({None: [f.name]}, schema=schema)["server"],
+                {"port": 8080, "name": "123", "timeout": None, "id": 42},
+            )
+            # other unions are not typed
+            self.assertEqual(cornflakes.ini_load({None: [f.name]}, schema={"name": int | str})["server"]["name"], 123)
+        finally:
+            os.remove(f.name)
+
+    def test_ini_load_stats(self):
+        with tempfile.NamedTemporaryFile("w", suffix=".ini", delete=False) as f:
+            f.write("[db]\nhost = localhost\nport = 5432\nready = true\n")
+            f.write("[api]\nid = 123e4567-e89b-12d3-a456-426614174000\n")
+        try:
+            result, stats = cornflakes.ini_load({None: [f.name]}, stats=True)
+            self.assertEqual(result, cornflakes.ini_load({None: [f.name]}))
+            self.assertEqual(
+                sorted(stats["nanoseconds"]), ["eval_type", "image", "materialize", "parse", "read", "tokenize"]
+            )
+            self.assertTrue(all(value >= 0 for value in stats["nanoseconds"].values()))
+            self.assertEqual(stats["files"], 1)
+            self.assertEqual(stats["bytes"], os.path.getsize(f.name))
+            self.assertEqual((stats["sections"], stats["keys"], stats["eval_type"]), (2, 4, 1))
+            self.assertEqual(stats["types"], {"str": 1, "int": 1, "bool": 1, "UUID": 1})
+        finally:
+            os.remove(f.name)
+
+    def test_ini_dump(self):
+        values = {"host": "localhost", "port": 5432, "ratio": 0.5, "debug": True, "quote": "it's", "empty": None}
+        ini_bytes = cornflakes.ini_dump([("db", values, None)])
+        self.assertEqual(
+            ini_bytes,
+            bytearray(b"[db]\nhost='localhost'\nport=5432\nratio='0.5'\ndebug='True'\nquote=\"it's\"\nempty=\n\n"),
+        )
+
+        with tempfile.NamedTemporaryFile("wb", suffix=".ini", delete=False) as f:
+            f.write(ini_bytes)
+        try:
+            del values["empty"]
+            self.assertEqual(cornflakes.ini_load({None: [f.name]}), {"db": values})
+        finally:
+            os.remove(f.name)
+
+    def test_ini_dump_many_sections(self):
+        """The native buffer matches joining the sections in python."""
+        sections = [
+            (f"section_{section}", {f"key_{key}": f"value_{key}" for key in range(50)}, None)
+            for section in range(2000)
+        ]
+        python_bytes = bytearray()
+        for title, values, _ in sections:
+            python_bytes.extend(bytes(f"[{title}]\n", "utf-8"))
+            python_bytes.extend(
+                bytes("\n".join(f"{key}={type_to_str(value)!r}" for key, value in values.items()), "utf-8")
+            )
+            python_bytes.extend(b"\n\n")
+        self.assertEqual(cornflakes.ini_dump(sections, type_to_str), python_bytes)
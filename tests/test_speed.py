@@ -1,5 +1,6 @@
 from dataclasses import asdict
 import os
+import tempfile
 from time import perf_counter
 import unittest
 
@@ -26,6 +27,22 @@ class TestSpeed(unittest.TestCase):
             cornflakes.ini_load("tests/configs/default.ini")
         self.assertTrue(0.2 > (perf_counter() - s))
 
+    @pytest.mark.skipif(os.environ.get("NOX_RUNNING", "False"))
+    def test_ini_load_large_file(self):
+        """Multi-MB files are read into one owned buffer and tokenized without copying values."""
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            file = os.path.join(tmp_dir, "large.ini")
+            with open(file, "w") as f:
+                for section in range(2000):
+                    f.write(f"[section_{section}]\n")
+                    f.write("".join(f"key_{key} = {'x' * 40}_{key}\n" for key in range(50)))
+            self.assertTrue(os.path.getsize(file) > 4 * 1024 * 1024)
+
+            s = perf_counter()
+            for _ in range(10):
+                cornflakes.ini_load(file, sections={"section_0": "section_0"}, keys={"key_0": "key_0"})
+            self.assertTrue(2.0 > (perf_counter() - s))
+
     @pytest.mark.skipif(os.environ.get("NOX_RUNNING", "False"))
     def test_eval_csv_speed(self):
         s = perf_counter()